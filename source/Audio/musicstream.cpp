@@ -0,0 +1,271 @@
+//-- Description -------------------------------------------------------------/
+// methods of the music stream, and the ima adpcm decoder it uses             /
+//----------------------------------------------------------------------------/
+
+#include "musicstream.h"
+
+#include <QAudioSink>
+#include <QMediaDevices>
+#include <algorithm>
+#include <cstring>
+
+namespace {
+    constexpr uint16_t WAVE_FORMAT_IMA_ADPCM = 0x11;
+
+    // clang-format off
+    constexpr int16_t STEP_TABLE[89] = {
+        7,     8,     9,     10,    11,    12,    13,    14,    16,    17,
+        19,    21,    23,    25,    28,    31,    34,    37,    41,    45,
+        50,    55,    60,    66,    73,    80,    88,    97,    107,   118,
+        130,   143,   157,   173,   190,   209,   230,   253,   279,   307,
+        337,   371,   408,   449,   494,   544,   598,   658,   724,   796,
+        876,   963,   1060,  1166,  1282,  1411,  1552,  1707,  1878,  2066,
+        2272,  2499,  2749,  3024,  3327,  3660,  4026,  4428,  4871,  5358,
+        5894,  6484,  7132,  7845,  8630,  9493,  10442, 11487, 12635, 13899,
+        15289, 16818, 18500, 20350, 22385, 24623, 27086, 29794, 32767
+    };
+
+    constexpr int8_t INDEX_TABLE[8] = { -1, -1, -1, -1, 2, 4, 6, 8 };
+    // clang-format on
+
+    uint16_t
+    readU16(const uchar *p)
+    {
+        return uint16_t(p[0] | (p[1] << 8));
+    }
+
+    uint32_t
+    readU32(const uchar *p)
+    {
+        return uint32_t(p[0]) | (uint32_t(p[1]) << 8) | (uint32_t(p[2]) << 16)
+               | (uint32_t(p[3]) << 24);
+    }
+
+    struct Channel {
+        int predictor = 0;
+        int index     = 0;
+
+        int16_t
+        decode(uint8_t nibble)
+        {
+            const int step = STEP_TABLE[index];
+
+            int diff = step >> 3;
+            if (nibble & 4) { diff += step; }
+            if (nibble & 2) { diff += step >> 1; }
+            if (nibble & 1) { diff += step >> 2; }
+
+            predictor += (nibble & 8) ? -diff : diff;
+            predictor  = std::clamp(predictor, -32768, 32767);
+            index      = std::clamp(index + INDEX_TABLE[nibble & 7], 0, 88);
+
+            return int16_t(predictor);
+        }
+    };
+}    // namespace
+
+MusicStream::MusicStream(const QString &path, QObject *parent)
+    : QIODevice(parent)
+    , m_file(path)
+{
+}
+
+MusicStream::~MusicStream()
+{
+    if (m_sink != nullptr) { m_sink->stop(); }
+}
+
+bool
+MusicStream::start()
+{
+    if (m_sink != nullptr) { return true; }
+
+    if (!m_file.open(QIODevice::ReadOnly)) {
+        qWarning("MusicStream: can't open '%s'", qPrintable(m_file.fileName()));
+        return false;
+    }
+
+    // an uncompressed resource maps straight to the binary, only the pages
+    // that are played become resident
+    const uchar *file = m_file.map(0, m_file.size());
+    if (file == nullptr) {
+        m_contents = m_file.readAll();
+        file       = reinterpret_cast<const uchar *>(m_contents.constData());
+    }
+
+    if (!parseHeader(file, qint64(m_file.size()))) {
+        qWarning("MusicStream: '%s' is not an ima adpcm wav file",
+                 qPrintable(m_file.fileName()));
+        return false;
+    }
+
+    const QAudioDevice device = QMediaDevices::defaultAudioOutput();
+    if (device.isNull() || !device.isFormatSupported(m_format)) {
+        qWarning("MusicStream: no audio output for the music");
+        return false;
+    }
+
+    m_ring.assign(RING_BLOCKS * m_block_frames * m_channels, 0);
+
+    open(QIODevice::ReadOnly);
+
+    m_sink = new QAudioSink(device, m_format, this);
+    m_sink->setVolume(m_volume);
+    m_sink->start(this);
+
+    return true;
+}
+
+void
+MusicStream::setVolume(float volume)
+{
+    m_volume = volume;
+    if (m_sink != nullptr) { m_sink->setVolume(volume); }
+}
+
+qint64
+MusicStream::bytesAvailable() const
+{
+    // the loop never runs out
+    return qint64(m_ring.size() * sizeof(int16_t))
+           + QIODevice::bytesAvailable();
+}
+
+qint64
+MusicStream::readData(char *data, qint64 max_size)
+{
+    const size_t frame_bytes = m_channels * sizeof(int16_t);
+    const size_t wanted      = (size_t(max_size) / frame_bytes) * m_channels;
+
+    while (buffered() < wanted
+           && m_ring.size() - buffered() >= m_block_frames * m_channels) {
+        decodeBlock();
+    }
+
+    const size_t amount = std::min(wanted, buffered());
+    const size_t offset = m_read % m_ring.size();
+    const size_t first  = std::min(amount, m_ring.size() - offset);
+
+    std::memcpy(data, m_ring.data() + offset, first * sizeof(int16_t));
+    std::memcpy(data + first * sizeof(int16_t),
+                m_ring.data(),
+                (amount - first) * sizeof(int16_t));
+
+    m_read += amount;
+
+    return qint64(amount * sizeof(int16_t));
+}
+
+qint64
+MusicStream::writeData(const char *, qint64)
+{
+    return -1;
+}
+
+bool
+MusicStream::parseHeader(const uchar *file, qint64 size)
+{
+    if (size < 12 || std::memcmp(file, "RIFF", 4) != 0
+        || std::memcmp(file + 8, "WAVE", 4) != 0) {
+        return false;
+    }
+
+    const uchar *data      = nullptr;
+    size_t       data_size = 0;
+    bool         has_fmt   = false;
+
+    for (qint64 at = 12; at + 8 <= size;) {
+        const uchar *chunk      = file + at;
+        const qint64 chunk_size = readU32(chunk + 4);
+
+        if (at + 8 + chunk_size > size) { return false; }
+
+        if (std::memcmp(chunk, "fmt ", 4) == 0 && chunk_size >= 20) {
+            if (readU16(chunk + 8) != WAVE_FORMAT_IMA_ADPCM
+                || readU16(chunk + 22) != 4) {
+                return false;
+            }
+
+            m_channels     = readU16(chunk + 10);
+            m_block_align  = readU16(chunk + 20);
+            m_block_frames = readU16(chunk + 26);
+
+            m_format.setSampleRate(int(readU32(chunk + 12)));
+            m_format.setChannelCount(int(m_channels));
+            m_format.setSampleFormat(QAudioFormat::Int16);
+
+            has_fmt = true;
+        } else if (std::memcmp(chunk, "fact", 4) == 0 && chunk_size >= 4) {
+            m_total_frames = readU32(chunk + 8);
+        } else if (std::memcmp(chunk, "data", 4) == 0) {
+            data      = chunk + 8;
+            data_size = size_t(chunk_size);
+        }
+
+        // chunks are padded to an even size
+        at += 8 + chunk_size + (chunk_size & 1);
+    }
+
+    // every block starts with a 4 byte header per channel, then 8 samples
+    // per channel in every 4 bytes
+    if (!has_fmt || data == nullptr || m_channels < 1 || m_channels > 2
+        || m_block_align <= 4 * m_channels || m_block_align % (4 * m_channels)
+        || m_block_frames != (m_block_align - 4 * m_channels) * 2 / m_channels
+                                 + 1) {
+        return false;
+    }
+
+    m_blocks      = data;
+    m_block_count = data_size / m_block_align;
+
+    const size_t frames = m_block_count * m_block_frames;
+    if (m_total_frames == 0 || m_total_frames > frames) {
+        m_total_frames = frames;
+    }
+
+    return m_total_frames > 0;
+}
+
+void
+MusicStream::decodeBlock()
+{
+    const uchar *block  = m_blocks + m_block * m_block_align;
+    const size_t frames = std::min(m_block_frames, m_total_frames - m_frame);
+    const size_t size   = m_ring.size();
+
+    Channel channels[2];
+
+    for (size_t c = 0; c < m_channels; c++) {
+        channels[c].predictor = int16_t(readU16(block + 4 * c));
+        channels[c].index     = std::min<int>(block[4 * c + 2], 88);
+
+        m_ring[(m_write + c) % size] = int16_t(channels[c].predictor);
+    }
+
+    const uchar *nibbles = block + 4 * m_channels;
+
+    // the samples after the header come in groups of 8 per channel
+    for (size_t group = 0; 1 + group * 8 < frames; group++) {
+        for (size_t c = 0; c < m_channels; c++) {
+            for (size_t i = 0; i < 8; i++) {
+                const uint8_t byte   = nibbles[i / 2];
+                const uint8_t nibble = (i & 1) ? (byte >> 4) : (byte & 0x0F);
+                const int16_t sample = channels[c].decode(nibble);
+                const size_t  frame  = 1 + group * 8 + i;
+
+                if (frame < frames) {
+                    m_ring[(m_write + frame * m_channels + c) % size] = sample;
+                }
+            }
+            nibbles += 4;
+        }
+    }
+
+    m_write += frames * m_channels;
+    m_frame += frames;
+
+    if (++m_block == m_block_count || m_frame >= m_total_frames) {
+        m_block = 0;
+        m_frame = 0;
+    }
+}
@@ -0,0 +1,76 @@
+//-- Description -------------------------------------------------------------/
+// Background music streamed from an IMA ADPCM wav file. The file stays       /
+// compressed, blocks are decoded on demand into a small ring buffer the      /
+// audio sink pulls from. After the last block the first one is decoded       /
+// again, so the loop has no gap.                                             /
+//----------------------------------------------------------------------------/
+
+#ifndef MUSICSTREAM_H
+#define MUSICSTREAM_H
+
+#include <QAudioFormat>
+#include <QByteArray>
+#include <QFile>
+#include <QIODevice>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+class QAudioSink;
+
+class MusicStream : public QIODevice {
+    Q_OBJECT
+
+public:
+    // nothing is read from 'path' until start()
+    explicit MusicStream(const QString &path, QObject *parent = nullptr);
+    ~MusicStream() override;
+
+    // open the file and start playing it, false if it's not an ima adpcm
+    // wav, or there is no audio device for it
+    bool start();
+
+    void setVolume(float volume);
+
+    bool   isSequential() const override { return true; }
+    qint64 bytesAvailable() const override;
+
+protected:
+    qint64 readData(char *data, qint64 max_size) override;
+    qint64 writeData(const char *data, qint64 max_size) override;
+
+private:
+    static constexpr size_t RING_BLOCKS = 4;
+
+    // find the format and the data chunk of the wav file
+    bool parseHeader(const uchar *file, qint64 size);
+
+    // decode the next block into the ring buffer, the first block follows
+    // the last one
+    void decodeBlock();
+
+    size_t buffered() const { return m_write - m_read; }    // samples
+
+    QFile        m_file;
+    QByteArray   m_contents;    // only when the file can't be mapped
+    const uchar *m_blocks      = nullptr;
+    size_t       m_block_count = 0;
+
+    QAudioFormat m_format;
+    QAudioSink  *m_sink   = nullptr;
+    float        m_volume = 1.0F;
+
+    size_t m_channels     = 0;
+    size_t m_block_align  = 0;    // bytes
+    size_t m_block_frames = 0;
+    size_t m_total_frames = 0;
+    size_t m_block        = 0;    // next block to decode
+    size_t m_frame        = 0;    // frames decoded since the loop started
+
+    // m_read and m_write only grow, they are wrapped when indexing
+    std::vector<int16_t> m_ring;
+    size_t               m_read  = 0;
+    size_t               m_write = 0;
+};
+
+#endif    // MUSICSTREAM_H
@@ -0,0 +1,240 @@
+//-- Description -------------------------------------------------------------/
+// methods of the sound effect mixer                                          /
+//----------------------------------------------------------------------------/
+
+#include "sfxmixer.h"
+
+#include "../Config/config.h"
+
+#include <QAudioSink>
+#include <QCoreApplication>
+#include <QFile>
+#include <QMediaDevices>
+#include <algorithm>
+#include <cstring>
+
+SfxMixer::SfxMixer()
+{
+    m_format.setSampleRate(SAMPLE_RATE);
+    m_format.setChannelCount(CHANNELS);
+    m_format.setSampleFormat(QAudioFormat::Int16);
+
+    m_since_start.fill(MIN_INTERVAL_FRAMES);
+
+    load(Effect::PLACEMENT, Config::AudioFiles::PLACEMENT_FX);
+}
+
+SfxMixer::~SfxMixer()
+{
+    if (m_thread.isRunning()) {
+        QMetaObject::invokeMethod(this,
+                                  &SfxMixer::closeSink,
+                                  Qt::BlockingQueuedConnection);
+        m_thread.quit();
+        m_thread.wait();
+    }
+}
+
+void
+SfxMixer::start()
+{
+    if (m_thread.isRunning()) { return; }
+
+    m_thread.setObjectName("SfxMixer");
+    m_thread.start(QThread::TimeCriticalPriority);
+
+    moveToThread(&m_thread);
+
+    QMetaObject::invokeMethod(this, &SfxMixer::openSink, Qt::QueuedConnection);
+}
+
+qint64
+SfxMixer::bytesAvailable() const
+{
+    // silence is mixed when no voice is playing
+    return qint64(SAMPLE_RATE * CHANNELS * sizeof(int16_t))
+           + QIODevice::bytesAvailable();
+}
+
+qint64
+SfxMixer::readData(char *data, qint64 max_size)
+{
+    const size_t frames  = size_t(max_size) / (CHANNELS * sizeof(int16_t));
+    const size_t samples = frames * CHANNELS;
+
+    if (frames == 0) { return 0; }
+
+    startVoices();
+
+    m_mix.assign(samples, 0);
+
+    for (Voice &voice : m_voices) {
+        if (voice.samples == nullptr) { continue; }
+
+        const size_t amount
+            = std::min(samples, voice.samples->size() - voice.position);
+        const int16_t *source = voice.samples->data() + voice.position;
+
+        for (size_t i = 0; i < amount; i++) { m_mix[i] += source[i]; }
+
+        voice.position += amount;
+        if (voice.position == voice.samples->size()) {
+            voice.samples = nullptr;
+        }
+    }
+
+    const float volume = m_volume.load(std::memory_order_relaxed);
+
+    int16_t *out = reinterpret_cast<int16_t *>(data);
+    for (size_t i = 0; i < samples; i++) {
+        out[i] = int16_t(std::clamp(int32_t(float(m_mix[i]) * volume),
+                                    -32768,
+                                    32767));
+    }
+
+    for (size_t &since : m_since_start) { since += frames; }
+
+    return qint64(samples * sizeof(int16_t));
+}
+
+qint64
+SfxMixer::writeData(const char *, qint64)
+{
+    return -1;
+}
+
+bool
+SfxMixer::load(Effect effect, const QString &path)
+{
+    QFile file(path);
+
+    if (!file.open(QIODevice::ReadOnly)) {
+        qWarning("SfxMixer: can't open '%s'", qPrintable(path));
+        return false;
+    }
+
+    const QByteArray contents = file.readAll();
+    const uchar     *wav  = reinterpret_cast<const uchar *>(contents.constData());
+    const qint64     size = contents.size();
+
+    auto u16 = [&](qint64 at) {
+        return uint16_t(wav[at] | (wav[at + 1] << 8));
+    };
+    auto u32 = [&](qint64 at) {
+        return uint32_t(u16(at)) | (uint32_t(u16(at + 2)) << 16);
+    };
+
+    if (size < 12 || std::memcmp(wav, "RIFF", 4) != 0
+        || std::memcmp(wav + 8, "WAVE", 4) != 0) {
+        qWarning("SfxMixer: '%s' is not a wav file", qPrintable(path));
+        return false;
+    }
+
+    int    channels = 0;
+    qint64 data = 0, data_size = 0;
+
+    for (qint64 at = 12; at + 8 <= size;) {
+        const qint64 chunk_size = u32(at + 4);
+
+        if (at + 8 + chunk_size > size) { break; }
+
+        if (std::memcmp(wav + at, "fmt ", 4) == 0 && chunk_size >= 16) {
+            // only 16 bit pcm at the mixer's rate
+            if (u16(at + 8) == 1 && u16(at + 22) == 16
+                && u32(at + 12) == uint32_t(SAMPLE_RATE)) {
+                channels = u16(at + 10);
+            }
+        } else if (std::memcmp(wav + at, "data", 4) == 0) {
+            data      = at + 8;
+            data_size = chunk_size;
+        }
+
+        // chunks are padded to an even size
+        at += 8 + chunk_size + (chunk_size & 1);
+    }
+
+    if ((channels != 1 && channels != 2) || data == 0) {
+        qWarning("SfxMixer: '%s' must be 16 bit pcm at %d Hz",
+                 qPrintable(path),
+                 SAMPLE_RATE);
+        return false;
+    }
+
+    const size_t frames = size_t(data_size) / (channels * sizeof(int16_t));
+
+    std::vector<int16_t> &samples = m_bank[size_t(effect)];
+    samples.resize(frames * CHANNELS);
+
+    for (size_t frame = 0; frame < frames; frame++) {
+        for (size_t c = 0; c < CHANNELS; c++) {
+            const size_t source
+                = frame * channels + std::min<size_t>(c, channels - 1);
+
+            samples[frame * CHANNELS + c]
+                = int16_t(u16(data + qint64(source * sizeof(int16_t))));
+        }
+    }
+
+    return true;
+}
+
+void
+SfxMixer::startVoices()
+{
+    for (size_t effect = 0; effect < m_bank.size(); effect++) {
+        // too soon after the last one, the triggers wait and are merged
+        if (m_since_start[effect] < MIN_INTERVAL_FRAMES
+            || m_pending[effect].exchange(0, std::memory_order_relaxed) == 0
+            || m_bank[effect].empty()) {
+            continue;
+        }
+
+        // a free voice, or the one that has played the longest
+        Voice *voice = &m_voices[0];
+        for (Voice &v : m_voices) {
+            if (v.samples == nullptr) {
+                voice = &v;
+                break;
+            }
+            if (v.position > voice->position) { voice = &v; }
+        }
+
+        voice->samples  = &m_bank[effect];
+        voice->position = 0;
+
+        m_since_start[effect] = 0;
+    }
+}
+
+void
+SfxMixer::openSink()
+{
+    const QAudioDevice device = QMediaDevices::defaultAudioOutput();
+
+    if (device.isNull() || !device.isFormatSupported(m_format)) {
+        qWarning("SfxMixer: no audio output for the sound effects");
+        return;
+    }
+
+    open(QIODevice::ReadOnly);
+
+    // a short buffer, the effects should follow the moves closely
+    m_sink = new QAudioSink(device, m_format, this);
+    m_sink->setBufferSize(
+        m_format.bytesForDuration(qint64(SINK_BUFFER_MS) * 1000));
+    m_sink->start(this);
+}
+
+void
+SfxMixer::closeSink()
+{
+    if (m_sink != nullptr) {
+        m_sink->stop();
+        delete m_sink;
+        m_sink = nullptr;
+    }
+
+    close();
+
+    moveToThread(QCoreApplication::instance()->thread());
+}
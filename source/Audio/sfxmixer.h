@@ -0,0 +1,96 @@
+//-- Description -------------------------------------------------------------/
+// Mixer for the short sound effects. Every effect is decoded once into a     /
+// shared PCM bank, and a bounded amount of voices are mixed on the mixer's   /
+// own thread. Playing an effect only bumps an atomic counter, triggers that  /
+// come faster than an effect can be heard are merged into one voice.         /
+//----------------------------------------------------------------------------/
+
+#ifndef SFXMIXER_H
+#define SFXMIXER_H
+
+#include "../Metrics/metrics.h"
+
+#include <QAudioFormat>
+#include <QIODevice>
+#include <QThread>
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+class QAudioSink;
+
+class SfxMixer : public QIODevice {
+    Q_OBJECT
+
+public:
+    enum class Effect { PLACEMENT, COUNT };
+
+    // decodes the bank, the mixer has no parent since it's moved to it's
+    // own thread
+    SfxMixer();
+    ~SfxMixer() override;
+
+    // start the mixer thread and open the audio output on it
+    void start();
+
+    // can be called from any thread, never blocks
+    void play(Effect effect)
+    {
+        m_pending[size_t(effect)].fetch_add(1, std::memory_order_relaxed);
+        Metrics::add(Metrics::Counter::AUDIO_TRIGGERS);
+    }
+
+    void setVolume(float volume)
+    {
+        m_volume.store(volume, std::memory_order_relaxed);
+    }
+
+    bool   isSequential() const override { return true; }
+    qint64 bytesAvailable() const override;
+
+protected:
+    qint64 readData(char *data, qint64 max_size) override;
+    qint64 writeData(const char *data, qint64 max_size) override;
+
+private:
+    static constexpr int    SAMPLE_RATE     = 48000;
+    static constexpr int    CHANNELS        = 2;
+    static constexpr size_t MAX_VOICES      = 6;
+    static constexpr size_t MIN_INTERVAL_MS = 40;    // per effect
+    static constexpr size_t MIN_INTERVAL_FRAMES
+        = SAMPLE_RATE * MIN_INTERVAL_MS / 1000;
+    static constexpr int SINK_BUFFER_MS = 20;
+
+    struct Voice {
+        const std::vector<int16_t> *samples  = nullptr;
+        size_t                      position = 0;    // samples
+    };
+
+    // decode a 16 bit pcm wav file into the bank, mono is made stereo
+    bool load(Effect effect, const QString &path);
+
+    // turn the pending triggers into voices, on the mixer thread
+    void startVoices();
+
+    // both run on the mixer thread, closing moves the mixer back to the
+    // main thread so it can be deleted there
+    void openSink();
+    void closeSink();
+
+    std::array<std::vector<int16_t>, size_t(Effect::COUNT)> m_bank;
+    std::array<std::atomic<uint32_t>, size_t(Effect::COUNT)> m_pending {};
+    std::atomic<float>                                       m_volume { 1.0F };
+
+    // only touched on the mixer thread
+    std::array<size_t, size_t(Effect::COUNT)> m_since_start {};    // frames
+    std::array<Voice, MAX_VOICES>             m_voices {};
+    std::vector<int32_t>                      m_mix;
+
+    QAudioFormat m_format;
+    QAudioSink  *m_sink = nullptr;
+    QThread      m_thread;
+};
+
+#endif    // SFXMIXER_H
@@ -0,0 +1,478 @@
+//-- Description -------------------------------------------------------------/
+// the benchmark scenarios. only the work being measured is timed, boards are /
+// set up and scripts are generated before the timer starts.                  /
+//----------------------------------------------------------------------------/
+
+#include "benchmark.h"
+
+#include "../BoardRenderer/boardrenderer.h"
+#include "../Config/config.h"
+#include "../HanoiStack/hanoisolver.h"
+#include "../HanoiStack/hanoistack.h"
+#include "../MoveHistory/movehistory.h"
+#include "../Random/random.h"
+#include "../Replay/replay.h"
+
+#include <QDateTime>
+#include <QElapsedTimer>
+#include <QFileInfo>
+#include <QImage>
+#include <QPainter>
+#include <QSysInfo>
+#include <QTemporaryDir>
+#include <QThread>
+#include <algorithm>
+#include <cstdio>
+#include <numeric>
+
+#if defined(Q_OS_UNIX)
+    #include <sys/resource.h>
+#endif
+
+#ifndef HANOI_VERSION
+    #define HANOI_VERSION "unknown"
+#endif
+#ifndef HANOI_COMPILER
+    #define HANOI_COMPILER "unknown"
+#endif
+#ifndef HANOI_BUILD_TYPE
+    #define HANOI_BUILD_TYPE "unknown"
+#endif
+
+namespace {
+    using Move = std::pair<size_t, size_t>;
+
+    // solver cases with less moves are repeated, so they take long enough
+    // to be timed
+    constexpr size_t MIN_SOLVE_MOVES = size_t(1) << 16;
+
+    constexpr size_t SESSION_STACKS = 3;
+    constexpr size_t SESSION_SLICES = 5;
+    constexpr size_t SESSION_SEEKS  = 1000;
+
+    constexpr size_t RESET_STACKS = 3;
+    constexpr size_t RESET_SLICES = Config::SLICE_MAX;
+
+    // a board with every slice on the first stack
+    struct Board {
+        HanoiStack stacks[Config::STACK_MAX];
+
+        explicit Board(size_t slice_amount)
+        {
+            for (size_t i = 0; i < Config::STACK_MAX; i++) {
+                stacks[i] = HanoiStack(i);
+            }
+            HanoiStack::fillStack(&stacks[0], slice_amount);
+        }
+
+        void reset(size_t slice_amount)
+        {
+            for (HanoiStack &stack : stacks) { stack.clearStack(); }
+            HanoiStack::fillStack(&stacks[0], slice_amount);
+        }
+
+        Move makeLegalMove(size_t a, size_t b)
+        {
+            return HanoiStack::makeLegalMove(&stacks[a], &stacks[b]);
+        }
+    };
+
+    double
+    msSince(const QElapsedTimer &timer)
+    {
+        return timer.nsecsElapsed() / 1e6;
+    }
+}    // namespace
+
+QStringList
+Benchmark::scenarioNames()
+{
+    QStringList names;
+    for (const auto &[name, scenario] : scenarios()) { names << name; }
+    return names;
+}
+
+QJsonObject
+Benchmark::run(const Options &options)
+{
+    QJsonObject results;
+
+    for (const auto &[name, scenario] : scenarios()) {
+        if (!options.scenarios.isEmpty() && !options.scenarios.contains(name)) {
+            continue;
+        }
+
+        fprintf(stderr, "bench: %s\n", qPrintable(name));
+
+        QElapsedTimer timer;
+        timer.start();
+
+        const QJsonArray cases   = scenario(options);
+        const double     wall_ms = msSince(timer);
+        const int64_t    rss     = peakRssKb();
+
+        // the peak rss is of the whole process, up to the end of the
+        // scenario
+        results[name] = QJsonObject {
+            { "cases", cases },
+            { "wall_ms", wall_ms },
+            { "peak_rss_kb", (rss < 0) ? QJsonValue() : qint64(rss) },
+        };
+    }
+
+    return QJsonObject {
+        { "format", FORMAT },
+        { "seed", QString::number(options.seed, 16) },
+        { "environment", environment() },
+        { "scenarios", results },
+    };
+}
+
+const std::vector<std::pair<QString, Benchmark::Scenario>> &
+Benchmark::scenarios()
+{
+    static const std::vector<std::pair<QString, Scenario>> S {
+        { "solve", &Benchmark::solve },
+        { "replay", &Benchmark::replay },
+        { "render", &Benchmark::render },
+        { "reset_solve", &Benchmark::resetSolve },
+    };
+
+    return S;
+}
+
+QJsonArray
+Benchmark::solve(const Options &)
+{
+    QJsonArray cases;
+
+    for (size_t stack_amount = 3; stack_amount <= Config::STACK_MAX;
+         stack_amount++) {
+        for (size_t slice_amount = 3; slice_amount <= 20; slice_amount++) {
+            const size_t      goal = stack_amount - 1;
+            const HanoiSolver solver(slice_amount, goal);
+            const size_t      moves = solver.getMoveCount();
+            const size_t runs = std::max<size_t>(1, MIN_SOLVE_MOVES / moves);
+
+            Board  board(slice_amount);
+            bool   solved   = true;
+            double total_ms = 0;
+
+            for (size_t run = 0; run < runs; run++) {
+                if (run > 0) { board.reset(slice_amount); }
+
+                QElapsedTimer timer;
+                timer.start();
+
+                for (size_t i = 1; i <= moves; i++) {
+                    const Move move = solver.getMove(i);
+                    board.makeLegalMove(move.first, move.second);
+                }
+
+                total_ms += msSince(timer);
+                solved
+                    = solved && board.stacks[goal].getSize() == slice_amount;
+            }
+
+            const double wall_ms = total_ms / runs;
+
+            cases.append(QJsonObject {
+                { "stacks", qint64(stack_amount) },
+                { "slices", qint64(slice_amount) },
+                { "moves", qint64(moves) },
+                { "runs", qint64(runs) },
+                { "wall_ms", wall_ms },
+                { "moves_per_s", moves / (wall_ms / 1000) },
+                { "solved", solved },
+            });
+        }
+    }
+
+    return cases;
+}
+
+QJsonArray
+Benchmark::replay(const Options &options)
+{
+    // the script a player follows: a move between two stacks (which may be
+    // illegal), or an undo every 10 actions on average
+    const Move UNDO(SIZE_MAX, SIZE_MAX);
+
+    Random            random(options.seed);
+    std::vector<Move> script;
+    script.reserve(options.session_moves);
+
+    for (size_t i = 0; i < options.session_moves; i++) {
+        if (random.range(0, 9) == 0) {
+            script.push_back(UNDO);
+            continue;
+        }
+
+        const size_t source = random.range(0, SESSION_STACKS - 1);
+        const size_t offset = random.range(1, SESSION_STACKS - 1);
+        script.emplace_back(source, (source + offset) % SESSION_STACKS);
+    }
+
+    // play it on a board, with the history the game keeps
+    Board       board(SESSION_SLICES);
+    MoveHistory history;
+    size_t      illegal = 0, undos = 0;
+
+    QElapsedTimer timer;
+    timer.start();
+
+    for (const Move &action : script) {
+        if (action == UNDO) {
+            if (!history.canUndo()) { continue; }
+
+            const MoveHistory::Move undone = history.undoMove();
+            history.stepBack();
+            HanoiStack::tryMove(&board.stacks[undone.second],
+                                &board.stacks[undone.first]);
+            ++undos;
+        } else if (HanoiStack::tryMove(&board.stacks[action.first],
+                                       &board.stacks[action.second])
+                   == HanoiStack::MoveStatus::OK) {
+            history.record(action.first, action.second);
+        } else {
+            ++illegal;
+        }
+    }
+
+    const double play_ms = msSince(timer);
+
+    std::vector<Move> moves;
+    history.moves(moves);
+
+    // save, load and seek through the replay of the game
+    QTemporaryDir dir;
+    const QString path = dir.filePath("session.hnr");
+
+    Replay::Info info;
+    info.stack_amount = SESSION_STACKS;
+    info.slice_amount = SESSION_SLICES;
+    info.goal         = SESSION_STACKS - 1;
+    info.seed         = options.seed;
+
+    timer.restart();
+    const bool   saved   = dir.isValid() && Replay::save(path, info, moves);
+    const double save_ms = msSince(timer);
+
+    Replay replay;
+
+    timer.restart();
+    const bool   opened  = saved && replay.open(path);
+    const double open_ms = msSince(timer);
+
+    timer.restart();
+    std::vector<Move> decoded;
+    const bool        complete  = opened && replay.moves(decoded);
+    const double      decode_ms = msSince(timer);
+
+    std::vector<double>  seek_ms;
+    std::vector<uint8_t> state;
+
+    for (size_t i = 0; opened && i < SESSION_SEEKS; i++) {
+        const size_t move = replay.moveCount() * i / (SESSION_SEEKS - 1);
+
+        timer.restart();
+        replay.stateAt(move, state);
+        seek_ms.push_back(msSince(timer));
+    }
+
+    return QJsonArray { QJsonObject {
+        { "stacks", qint64(SESSION_STACKS) },
+        { "slices", qint64(SESSION_SLICES) },
+        { "actions", qint64(script.size()) },
+        { "moves", qint64(moves.size()) },
+        { "illegal", qint64(illegal) },
+        { "undos", qint64(undos) },
+        { "play_ms", play_ms },
+        { "actions_per_s", script.size() / (play_ms / 1000) },
+        { "save_ms", save_ms },
+        { "file_bytes", QFileInfo(path).size() },
+        { "open_ms", open_ms },
+        { "decode_ms", decode_ms },
+        { "seek_ms", percentiles(seek_ms) },
+        { "valid", complete && decoded == moves },
+    } };
+}
+
+QJsonArray
+Benchmark::render(const Options &options)
+{
+    struct Case {
+        size_t stack_amount, slice_amount;
+    };
+
+    // the 64 slice boards are mostly drawn as spans
+    constexpr Case CASES[] = { { 3, 5 }, { 4, 10 }, { 5, 20 }, { 3, 64 } };
+
+    const QSize SIZES[] = {
+        QSize(640, 360),
+        QSize(1280, 720),
+        QSize(1920, 1080),
+        QSize(3840, 2160),
+    };
+
+    QJsonArray cases;
+
+    for (const Case &c : CASES) {
+        for (const QSize &size : SIZES) {
+            const size_t      goal = c.stack_amount - 1;
+            const HanoiSolver solver(c.slice_amount, goal);
+
+            Board         board(c.slice_amount);
+            BoardRenderer renderer;
+            renderer.setLayout(QSizeF(size), c.stack_amount, c.slice_amount);
+            renderer.setStackTint(Config::Theme::stack_tint);
+            renderer.setSliceTint(Config::Theme::slice_tint);
+
+            QImage frame(size, QImage::Format_ARGB32_Premultiplied);
+
+            const auto draw = [&]() {
+                frame.fill(Config::Theme::background_tint);
+
+                QPainter painter(&frame);
+                renderer.drawBoard(board.stacks,
+                                   goal,
+                                   BoardRenderer::GoalMarker::INDICATOR,
+                                   &painter);
+            };
+
+            // the first frame also tints and scales the sprites
+            QElapsedTimer timer;
+            timer.start();
+            draw();
+            const double first_frame_ms = msSince(timer);
+
+            std::vector<double> frame_ms;
+            frame_ms.reserve(options.frames);
+
+            for (size_t i = 0, move = 0; i < options.frames; i++) {
+                // start over once the board is solved
+                if (move == solver.getMoveCount()) {
+                    board.reset(c.slice_amount);
+                    move = 0;
+                }
+
+                const Move next = solver.getMove(++move);
+                board.makeLegalMove(next.first, next.second);
+
+                timer.restart();
+                draw();
+                frame_ms.push_back(msSince(timer));
+            }
+
+            const double total_ms
+                = std::accumulate(frame_ms.begin(), frame_ms.end(), 0.0);
+
+            cases.append(QJsonObject {
+                { "stacks", qint64(c.stack_amount) },
+                { "slices", qint64(c.slice_amount) },
+                { "width", size.width() },
+                { "height", size.height() },
+                { "frames", qint64(options.frames) },
+                { "first_frame_ms", first_frame_ms },
+                { "fps", options.frames / (total_ms / 1000) },
+                { "frame_ms", percentiles(frame_ms) },
+            });
+        }
+    }
+
+    return cases;
+}
+
+QJsonArray
+Benchmark::resetSolve(const Options &options)
+{
+    const HanoiSolver solver(RESET_SLICES, RESET_STACKS - 1);
+
+    Board       board(RESET_SLICES);
+    MoveHistory history;
+
+    std::vector<double> loop_ms;
+    loop_ms.reserve(options.loops);
+
+    for (size_t loop = 0; loop < options.loops; loop++) {
+        QElapsedTimer timer;
+        timer.start();
+
+        board.reset(RESET_SLICES);
+        history.clear();
+
+        for (size_t i = 1; i <= solver.getMoveCount(); i++) {
+            const Move move = solver.getMove(i);
+            const Move made = board.makeLegalMove(move.first, move.second);
+            history.record(made.first, made.second);
+        }
+
+        loop_ms.push_back(msSince(timer));
+    }
+
+    const double wall_ms
+        = std::accumulate(loop_ms.begin(), loop_ms.end(), 0.0);
+
+    return QJsonArray { QJsonObject {
+        { "stacks", qint64(RESET_STACKS) },
+        { "slices", qint64(RESET_SLICES) },
+        { "loops", qint64(options.loops) },
+        { "wall_ms", wall_ms },
+        { "moves_per_s",
+          options.loops * solver.getMoveCount() / (wall_ms / 1000) },
+        { "loop_ms", percentiles(loop_ms) },
+    } };
+}
+
+QJsonObject
+Benchmark::percentiles(std::vector<double> &ms)
+{
+    if (ms.empty()) { return QJsonObject(); }
+
+    std::sort(ms.begin(), ms.end());
+
+    const auto percentile = [&](double p) {
+        return ms[size_t((ms.size() - 1) * p)];
+    };
+
+    return QJsonObject {
+        { "mean", std::accumulate(ms.begin(), ms.end(), 0.0) / ms.size() },
+        { "p50", percentile(0.5) },
+        { "p90", percentile(0.9) },
+        { "p99", percentile(0.99) },
+        { "max", ms.back() },
+    };
+}
+
+QJsonObject
+Benchmark::environment()
+{
+    return QJsonObject {
+        { "version", HANOI_VERSION },
+        { "compiler", HANOI_COMPILER },
+        { "build_type", HANOI_BUILD_TYPE },
+        { "qt", qVersion() },
+        { "os", QSysInfo::prettyProductName() },
+        { "cpu", QSysInfo::currentCpuArchitecture() },
+        { "threads", QThread::idealThreadCount() },
+        { "timestamp",
+          QDateTime::currentDateTimeUtc().toString(Qt::ISODate) },
+    };
+}
+
+int64_t
+Benchmark::peakRssKb()
+{
+#if defined(Q_OS_UNIX)
+    struct rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) != 0) { return -1; }
+
+    #if defined(Q_OS_DARWIN)
+    return int64_t(usage.ru_maxrss) / 1024;    // bytes
+    #else
+    return int64_t(usage.ru_maxrss);
+    #endif
+#else
+    return -1;
+#endif
+}
@@ -0,0 +1,72 @@
+//-- Description -------------------------------------------------------------/
+// Headless benchmark of fixed scenarios: solver runs, a scripted player      /
+// session saved to and replayed from a replay file, offscreen rendering and  /
+// reset/solve loops. Every scenario is deterministic, so the JSON report of  /
+// two builds can be compared key by key.                                     /
+//----------------------------------------------------------------------------/
+
+#ifndef BENCHMARK_H
+#define BENCHMARK_H
+
+#include <QJsonArray>
+#include <QJsonObject>
+#include <QString>
+#include <QStringList>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+class Benchmark {
+public:
+    // bump when a scenario or a key of the report changes
+    static constexpr int FORMAT = 3;
+
+    // the scripted session always plays the same game, unless it's changed
+    static constexpr uint64_t DEFAULT_SEED = 0x48414E4F;
+
+    struct Options {
+        size_t      frames        = 240;             // per render case
+        size_t      session_moves = 10000;           // player actions
+        size_t      loops         = 200;             // reset/solve iterations
+        uint64_t    seed          = DEFAULT_SEED;    // of the scripted session
+        QStringList scenarios;                       // empty: all of them
+    };
+
+    // the names Options::scenarios accepts
+    static QStringList scenarioNames();
+
+    // run the selected scenarios, and return the report
+    static QJsonObject run(const Options &options);
+
+    // the compiler, qt and machine the report was made with
+    static QJsonObject environment();
+
+    // peak resident set size of the process, -1 if it's unknown
+    static int64_t peakRssKb();
+
+private:
+    using Scenario = QJsonArray (*)(const Options &);
+
+    // every scenario by name, in the order they are ran
+    static const std::vector<std::pair<QString, Scenario>> &scenarios();
+
+    // solve every board from 3 to 20 slices, on 3 to 5 stacks
+    static QJsonArray solve(const Options &options);
+
+    // play a scripted session with undos, save it as a replay, then load,
+    // decode and seek through it
+    static QJsonArray replay(const Options &options);
+
+    // render frames of a solver run into a QImage, for several board and
+    // frame sizes
+    static QJsonArray render(const Options &options);
+
+    // reset the board and solve it again, like the reset & solve buttons
+    static QJsonArray resetSolve(const Options &options);
+
+    // p50, p90, p99 and max of 'ms', sorts it
+    static QJsonObject percentiles(std::vector<double> &ms);
+};
+
+#endif    // BENCHMARK_H
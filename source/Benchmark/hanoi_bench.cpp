@@ -0,0 +1,86 @@
+//-- Description -------------------------------------------------------------/
+// entry point of the hanoi_bench target, runs the benchmark scenarios        /
+// headless and writes the report as JSON to stdout, or to a file.            /
+//----------------------------------------------------------------------------/
+
+#include "../Config/config.h"
+#include "benchmark.h"
+
+#include <QCommandLineParser>
+#include <QFile>
+#include <QGuiApplication>
+#include <QJsonDocument>
+#include <cstdio>
+
+int
+main(int argc, char *argv[])
+{
+    // the renderer needs a gui application, but never a window
+    if (qEnvironmentVariableIsEmpty("QT_QPA_PLATFORM")) {
+        qputenv("QT_QPA_PLATFORM", "offscreen");
+    }
+
+    QGuiApplication a(argc, argv);
+
+    Benchmark::Options options;
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription(
+        "Runs the benchmark scenarios, and reports the results as JSON.");
+    parser.addHelpOption();
+    parser.addOptions({
+        { "output", "Write the report to a file.", "file" },
+        { "scenario",
+          "Run only this scenario, can be repeated. One of: "
+              + Benchmark::scenarioNames().join(", ") + ".",
+          "name" },
+        { "frames",
+          "Frames rendered per render case.",
+          "n",
+          QString::number(options.frames) },
+        { "session-moves",
+          "Actions of the scripted session.",
+          "n",
+          QString::number(options.session_moves) },
+        { "loops",
+          "Iterations of the reset/solve loop.",
+          "n",
+          QString::number(options.loops) },
+        { "seed",
+          "Seed of the scripted session.",
+          "n",
+          QString::number(options.seed) },
+    });
+    parser.process(a);
+
+    options.frames        = parser.value("frames").toULongLong();
+    options.session_moves = parser.value("session-moves").toULongLong();
+    options.loops         = parser.value("loops").toULongLong();
+    options.seed          = parser.value("seed").toULongLong(nullptr, 0);
+    options.scenarios     = parser.values("scenario");
+
+    for (const QString &name : options.scenarios) {
+        if (!Benchmark::scenarioNames().contains(name)) {
+            qCritical("unknown scenario '%s'", qPrintable(name));
+            return 1;
+        }
+    }
+
+    // every run starts cold, and leaves nothing in the user's cache
+    Config::Settings::sprite_cache = false;
+
+    const QByteArray report
+        = QJsonDocument(Benchmark::run(options)).toJson();
+
+    QFile      output(parser.value("output"));
+    const bool opened = parser.isSet("output")
+                            ? output.open(QIODevice::WriteOnly)
+                            : output.open(stdout, QIODevice::WriteOnly);
+
+    if (!opened || output.write(report) != report.size()) {
+        qCritical("can't write the report");
+        return 1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,74 @@
+//-- Description -------------------------------------------------------------/
+// entry point of the hanoi_microbench target, runs the microbenchmarks and   /
+// writes the report as JSON to stdout, or to a file.                         /
+//----------------------------------------------------------------------------/
+
+#include "microbenchmark.h"
+
+#include <QCommandLineParser>
+#include <QFile>
+#include <QGuiApplication>
+#include <QJsonDocument>
+#include <algorithm>
+
+int
+main(int argc, char *argv[])
+{
+    // the renderer lays out it's text with a gui application, but never
+    // opens a window
+    if (qEnvironmentVariableIsEmpty("QT_QPA_PLATFORM")) {
+        qputenv("QT_QPA_PLATFORM", "offscreen");
+    }
+
+    QGuiApplication a(argc, argv);
+
+    MicroBenchmark::Options options;
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription(
+        "Runs the microbenchmarks, and reports the ns/op as JSON.");
+    parser.addHelpOption();
+    parser.addOptions({
+        { "output", "Write the report to a file.", "file" },
+        { "filter",
+          "Run only the cases with this in their name, can be repeated.",
+          "text" },
+        { "samples",
+          "Samples taken of every case.",
+          "n",
+          QString::number(options.samples) },
+        { "sample-ms",
+          "Minimum length of a sample.",
+          "ms",
+          QString::number(options.sample_ms) },
+        { "warmup-ms",
+          "Warm up time of every case.",
+          "ms",
+          QString::number(options.warmup_ms) },
+        { "cpu", "Pin to this cpu, -1 for the current one.", "n", "-1" },
+        { "no-pin", "Don't pin to a cpu." },
+    });
+    parser.process(a);
+
+    options.samples   = std::max(1ULL, parser.value("samples").toULongLong());
+    options.sample_ms = parser.value("sample-ms").toDouble();
+    options.warmup_ms = parser.value("warmup-ms").toDouble();
+    options.cpu       = parser.value("cpu").toInt();
+    options.pin       = !parser.isSet("no-pin");
+    options.filters   = parser.values("filter");
+
+    const QByteArray report
+        = QJsonDocument(MicroBenchmark::run(options)).toJson();
+
+    QFile      output(parser.value("output"));
+    const bool opened = parser.isSet("output")
+                            ? output.open(QIODevice::WriteOnly)
+                            : output.open(stdout, QIODevice::WriteOnly);
+
+    if (!opened || output.write(report) != report.size()) {
+        qCritical("can't write the report");
+        return 1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,397 @@
+//-- Description -------------------------------------------------------------/
+// the microbenchmark cases and the sampling loop. the state a case works on  /
+// is set up once, and is left the way it was found by every call of it.     /
+//----------------------------------------------------------------------------/
+
+#include "microbenchmark.h"
+
+#include "../BoardRenderer/boardrenderer.h"
+#include "../Config/config.h"
+#include "../FrameExporter/frameexporter.h"
+#include "../HanoiStack/hanoisolver.h"
+#include "../HanoiStack/hanoistack.h"
+#include "../Utils/Stack.h"
+#include "../Utils/utils.h"
+#include "benchmark.h"
+
+#include <QElapsedTimer>
+#include <QJsonArray>
+#include <QPointF>
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <memory>
+#include <numeric>
+
+#if defined(Q_OS_LINUX)
+    #include <sched.h>
+#endif
+
+namespace {
+    using Move = std::pair<size_t, size_t>;
+
+    // operations per call of the cheap cases
+    constexpr size_t BATCH = 256;
+
+    // samples further than this many deviations from the median are counted
+    // as outliers, the deviation is the mad scaled to a normal distribution
+    constexpr double OUTLIER_DEVIATIONS = 3.0;
+
+    struct Board {
+        HanoiStack stacks[Config::STACK_MAX];
+
+        explicit Board(size_t slice_amount)
+        {
+            for (size_t i = 0; i < Config::STACK_MAX; i++) {
+                stacks[i] = HanoiStack(i);
+            }
+            HanoiStack::fillStack(&stacks[0], slice_amount);
+        }
+    };
+
+    double
+    median(std::vector<double> &values)
+    {
+        std::sort(values.begin(), values.end());
+
+        const size_t half = values.size() / 2;
+        return (values.size() % 2) ? values[half]
+                                   : (values[half - 1] + values[half]) / 2;
+    }
+}    // namespace
+
+QJsonObject
+MicroBenchmark::run(const Options &options)
+{
+    const int cpu = options.pin ? pinToCpu(options.cpu) : -1;
+    if (options.pin && cpu < 0) {
+        fprintf(stderr, "microbench: can't pin to a cpu, results are noisy\n");
+    }
+
+    QJsonArray results;
+
+    for (const Case &c : cases()) {
+        const bool selected
+            = options.filters.isEmpty()
+              || std::any_of(options.filters.begin(),
+                             options.filters.end(),
+                             [&](const QString &filter) {
+                                 return c.name.contains(filter);
+                             });
+
+        if (!selected) { continue; }
+
+        const QJsonObject result = measure(c, options);
+        const QJsonObject ns     = result["ns_per_op"].toObject();
+
+        fprintf(stderr,
+                "microbench: %-44s %10.2f ns/op  mad %6.2f%%\n",
+                qPrintable(c.name),
+                ns["median"].toDouble(),
+                100 * ns["mad"].toDouble()
+                    / std::max(ns["median"].toDouble(), 1e-9));
+
+        results.append(result);
+    }
+
+    return QJsonObject {
+        { "format", FORMAT },
+        { "environment", Benchmark::environment() },
+        { "cpu", (cpu < 0) ? QJsonValue() : cpu },
+        { "samples", qint64(options.samples) },
+        { "sample_ms", options.sample_ms },
+        { "warmup_ms", options.warmup_ms },
+        { "cases", results },
+    };
+}
+
+std::vector<MicroBenchmark::Case>
+MicroBenchmark::cases()
+{
+    std::vector<Case> list;
+
+    // HanoiStack ============================================================
+
+    {
+        const auto board = std::make_shared<Board>(Config::SLICE_MAX);
+        HanoiStack *stack = &board->stacks[0];
+
+        const auto pop_push = [board, stack]() {
+            for (size_t i = 0; i < BATCH; i++) {
+                HanoiSlice *slice = stack->pop();
+                stack->push(slice);
+                keep(slice);
+            }
+        };
+
+        const auto peek = [board, stack]() {
+            for (size_t i = 0; i < BATCH; i++) { keep(stack->peek()); }
+        };
+
+        const auto try_move = [board]() {
+            HanoiStack *a = &board->stacks[0];
+            HanoiStack *b = &board->stacks[1];
+            for (size_t i = 0; i < BATCH; i++) {
+                keep(HanoiStack::tryMove(a, b));
+                keep(HanoiStack::tryMove(b, a));
+            }
+        };
+
+        // one op is a walk over all the slices of the stack
+        const auto for_every_slice = [board, stack]() {
+            for (size_t i = 0; i < BATCH / 8; i++) {
+                size_t sum = 0;
+                stack->forEverySlice(
+                    [&](HanoiSlice *&slice) { sum += slice->getLabel(); });
+                keep(sum);
+            }
+        };
+
+        const auto for_every_slice_reversed = [board, stack]() {
+            for (size_t i = 0; i < BATCH / 8; i++) {
+                size_t sum = 0;
+                stack->forEverySliceReversed(
+                    [&](HanoiSlice *&slice) { sum += slice->getLabel(); });
+                keep(sum);
+            }
+        };
+
+        list.push_back({ "HanoiStack::pop+push", BATCH, pop_push });
+        list.push_back({ "HanoiStack::peek", BATCH, peek });
+        list.push_back({ "HanoiStack::tryMove", BATCH * 2, try_move });
+        list.push_back({ "HanoiStack::forEverySlice (10 slices)",
+                         BATCH / 8,
+                         for_every_slice });
+        list.push_back({ "HanoiStack::forEverySliceReversed (10 slices)",
+                         BATCH / 8,
+                         for_every_slice_reversed });
+    }
+
+    // what GameView::moveisLegal checks, over every ordered pair of the
+    // stacks of a 10 slice game a few moves in
+    {
+        const auto        board = std::make_shared<Board>(Config::SLICE_MAX);
+        const HanoiSolver solver(Config::SLICE_MAX, 2);
+
+        for (size_t i = 1; i <= 5; i++) {
+            const Move move = solver.getMove(i);
+            HanoiStack::makeLegalMove(&board->stacks[move.first],
+                                      &board->stacks[move.second]);
+        }
+
+        const auto is_legal_move = [board]() {
+            constexpr Move PAIRS[] = {
+                { 0, 1 }, { 0, 2 }, { 1, 0 }, { 1, 2 }, { 2, 0 }, { 2, 1 },
+            };
+
+            for (size_t i = 0; i < BATCH; i++) {
+                const Move &pair = PAIRS[i % 6];
+                keep(HanoiStack::isLegalMove(board->stacks[pair.first],
+                                             board->stacks[pair.second]));
+            }
+        };
+
+        list.push_back({ "HanoiStack::isLegalMove", BATCH, is_legal_move });
+    }
+
+    // a whole solve, then the same moves backwards to the starting board
+    {
+        const auto board = std::make_shared<Board>(Config::SLICE_MAX);
+        const auto moves = std::make_shared<std::vector<Move>>();
+
+        const HanoiSolver solver(Config::SLICE_MAX, 2);
+        for (size_t i = 1; i <= solver.getMoveCount(); i++) {
+            moves->push_back(solver.getMove(i));
+        }
+
+        const auto make_legal_move = [board, moves]() {
+            HanoiStack *stacks = board->stacks;
+            for (const Move &move : *moves) {
+                keep(HanoiStack::makeLegalMove(&stacks[move.first],
+                                               &stacks[move.second]));
+            }
+            for (auto move = moves->rbegin(); move != moves->rend(); ++move) {
+                keep(HanoiStack::makeLegalMove(&stacks[move->first],
+                                               &stacks[move->second]));
+            }
+        };
+
+        list.push_back({ "HanoiStack::makeLegalMove",
+                         moves->size() * 2,
+                         make_legal_move });
+    }
+
+    // Stack<T> ==============================================================
+
+    {
+        const auto stack = std::make_shared<Stack<int>>();
+
+        const auto push_pop = [stack]() {
+            for (size_t i = 0; i < BATCH; i++) {
+                stack->push(int(i));
+                keep(stack->getTop());
+                stack->pop();
+            }
+        };
+
+        // one op is a push, and it's share of the clear
+        const auto push_clear = [stack]() {
+            for (size_t i = 0; i < BATCH / 64; i++) {
+                for (int j = 0; j < 64; j++) { stack->push(j); }
+                stack->clear();
+            }
+        };
+
+        list.push_back({ "Stack<int>::push+pop", BATCH, push_pop });
+        list.push_back(
+            { "Stack<int>::push+clear (64 items)", BATCH, push_clear });
+    }
+
+    // BoardRenderer =========================================================
+
+    // the hit test GameView::calculateStackByPos uses, some of the points
+    // are outside of the board
+    {
+        const auto renderer = std::make_shared<BoardRenderer>();
+        renderer->setLayout(QSizeF(1280, 720), Config::STACK_MAX, 10);
+
+        const auto points = std::make_shared<std::vector<QPointF>>();
+        for (size_t i = 0; i < BATCH; i++) {
+            points->emplace_back(double(i * 7919 % 1400) - 60,
+                                 double(i * 104729 % 800) - 40);
+        }
+
+        const auto stack_at = [renderer, points]() {
+            for (const QPointF &point : *points) {
+                keep(renderer->stackAt(point));
+            }
+        };
+
+        list.push_back({ "BoardRenderer::stackAt", BATCH, stack_at });
+    }
+
+    // Utils =================================================================
+
+    const auto extract_time = []() {
+        for (size_t i = 0; i < BATCH; i++) {
+            keep(Utils::extractTimeFromMs((long long int)(i * 7919 * 1009)));
+        }
+    };
+
+    const auto num_to_char = []() {
+        for (size_t i = 0; i < BATCH; i++) {
+            keep(Utils::numToChar(i % Config::STACK_MAX));
+        }
+    };
+
+    list.push_back({ "Utils::extractTimeFromMs", BATCH, extract_time });
+    list.push_back({ "Utils::numToChar", BATCH, num_to_char });
+
+    // Move generators =======================================================
+
+    const auto get_move = []() {
+        const HanoiSolver solver(20, 2);
+        for (size_t i = 1; i <= BATCH * 4; i++) { keep(solver.getMove(i)); }
+    };
+
+    list.push_back({ "HanoiSolver::getMove", BATCH * 4, get_move });
+
+    {
+        FrameExporter::Options options;
+        options.slice_amount = 16;
+
+        const auto get_solver_moves = [options]() {
+            keep(FrameExporter::getSolverMoves(options));
+        };
+
+        list.push_back({ "FrameExporter::getSolverMoves (16 slices)",
+                         (size_t(1) << options.slice_amount) - 1,
+                         get_solver_moves });
+    }
+
+    return list;
+}
+
+QJsonObject
+MicroBenchmark::measure(const Case &c, const Options &options)
+{
+    QElapsedTimer warmup;
+    warmup.start();
+
+    // double the calls until a sample is long enough, for at least the
+    // warmup time
+    size_t calls = 1;
+    for (;;) {
+        QElapsedTimer timer;
+        timer.start();
+
+        for (size_t i = 0; i < calls; i++) { c.body(); }
+
+        const double ms = timer.nsecsElapsed() / 1e6;
+        if (ms >= options.sample_ms && warmup.elapsed() >= options.warmup_ms) {
+            break;
+        }
+        if (ms < options.sample_ms) { calls *= 2; }
+    }
+
+    std::vector<double> ns_per_op;
+    ns_per_op.reserve(options.samples);
+
+    for (size_t sample = 0; sample < options.samples; sample++) {
+        QElapsedTimer timer;
+        timer.start();
+
+        for (size_t i = 0; i < calls; i++) { c.body(); }
+
+        ns_per_op.push_back(double(timer.nsecsElapsed()) / (calls * c.ops));
+    }
+
+    std::vector<double> sorted = ns_per_op;
+    const double        mid    = median(sorted);
+
+    std::vector<double> deviations;
+    for (double ns : ns_per_op) { deviations.push_back(std::abs(ns - mid)); }
+    const double mad = median(deviations);
+
+    // 1.4826 scales the mad to the standard deviation of a normal
+    // distribution
+    const size_t outliers = std::count_if(
+        ns_per_op.begin(), ns_per_op.end(), [&](double ns) {
+            return std::abs(ns - mid) > OUTLIER_DEVIATIONS * 1.4826 * mad;
+        });
+
+    return QJsonObject {
+        { "name", c.name },
+        { "ops_per_sample", qint64(calls * c.ops) },
+        { "samples", qint64(ns_per_op.size()) },
+        { "outliers", qint64(outliers) },
+        { "ns_per_op",
+          QJsonObject {
+              { "median", mid },
+              { "mad", mad },
+              { "min", sorted.front() },
+              { "max", sorted.back() },
+              { "mean",
+                std::accumulate(sorted.begin(), sorted.end(), 0.0)
+                    / sorted.size() },
+          } },
+    };
+}
+
+int
+MicroBenchmark::pinToCpu(int cpu)
+{
+#if defined(Q_OS_LINUX)
+    if (cpu < 0) { cpu = sched_getcpu(); }
+    if (cpu < 0 || cpu >= CPU_SETSIZE) { return -1; }
+
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(cpu, &set);
+
+    return (sched_setaffinity(0, sizeof(set), &set) == 0) ? cpu : -1;
+#else
+    Q_UNUSED(cpu);
+    return -1;
+#endif
+}
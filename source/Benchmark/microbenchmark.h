@@ -0,0 +1,64 @@
+//-- Description -------------------------------------------------------------/
+// Microbenchmarks of the engine primitives, reported in nanoseconds per      /
+// operation. Every case is warmed up and calibrated so a sample runs for a   /
+// fixed minimum time, then sampled repeatedly on a single pinned cpu. The    /
+// median and the median absolute deviation are reported, so a few samples   /
+// disturbed by the system don't move the result.                             /
+//----------------------------------------------------------------------------/
+
+#ifndef MICROBENCHMARK_H
+#define MICROBENCHMARK_H
+
+#include <QJsonObject>
+#include <QString>
+#include <QStringList>
+#include <cstddef>
+#include <functional>
+#include <vector>
+
+class MicroBenchmark {
+public:
+    // bump when a case or a key of the report changes
+    static constexpr int FORMAT = 1;
+
+    struct Options {
+        size_t      samples   = 25;
+        double      sample_ms = 20;     // minimum length of a sample
+        double      warmup_ms = 200;    // per case
+        int         cpu       = -1;     // -1: the cpu it starts on
+        bool        pin       = true;
+        QStringList filters;            // parts of the names, empty: all
+    };
+
+    // run the selected cases, and return the report
+    static QJsonObject run(const Options &options);
+
+    // stop the compiler from optimising away the computation of 'value'
+    template<typename T> static inline void keep(const T &value)
+    {
+#if defined(__GNUC__) || defined(__clang__)
+        asm volatile("" : : "g"(&value) : "memory");
+#else
+        static const void *volatile sink;
+        sink = &value;
+#endif
+    }
+
+private:
+    // a call of 'body' runs 'ops' operations
+    struct Case {
+        QString               name;
+        size_t                ops;
+        std::function<void()> body;
+    };
+
+    static std::vector<Case> cases();
+
+    // warm up, calibrate and sample a case
+    static QJsonObject measure(const Case &c, const Options &options);
+
+    // pin the thread to a cpu, returns the cpu or -1 if it can't be pinned
+    static int pinToCpu(int cpu);
+};
+
+#endif    // MICROBENCHMARK_H
@@ -0,0 +1,517 @@
+//-- Description -------------------------------------------------------------/
+// methods that lay out and draw the board, they only touch the renderer and  /
+// the painter given, so they can run on any thread.                          /
+//----------------------------------------------------------------------------/
+
+#include "boardrenderer.h"
+
+#include "../Config/config.h"
+#include "../SpriteCache/spritecache.h"
+#include "../Trace/trace.h"
+#include "../Utils/utils.h"
+
+#include <QFile>
+#include <QPainter>
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+
+BoardRenderer::Asset::Asset(const char* path) : m_path(path)
+{
+    TRACE_SPAN("BoardRenderer::Asset::hash");
+
+    QFile file(path);
+    if (file.open(QIODevice::ReadOnly)) {
+        m_hash = SpriteCache::hashAsset(file.readAll());
+    }
+}
+
+const QImage&
+BoardRenderer::Asset::image() const
+{
+    std::call_once(m_decoded, [this]() {
+        TRACE_SPAN("BoardRenderer::Asset::decode");
+
+        m_image.load(m_path);
+        assert(!m_image.isNull());
+    });
+
+    return m_image;
+}
+
+const BoardRenderer::Source&
+BoardRenderer::source()
+{
+    // function local static, the first renderer hashes the files
+    // (thread-safe)
+    static const Source S;
+
+    return S;
+}
+
+void
+BoardRenderer::preloadSprites()
+{
+    TRACE_SPAN("BoardRenderer::preloadSprites");
+
+    const Source& s = source();
+
+    // a warm cache has every sprite of the usual settings
+    if (Config::Settings::sprite_cache && !SpriteCache::isEmpty()) { return; }
+
+    for (const Asset* asset :
+         { &s.stack_pole, &s.stack_base, &s.arrow, &s.slice, &s.dialog }) {
+        asset->image();
+    }
+}
+
+BoardRenderer::BoardRenderer()
+{
+    m_sprites.arrow_tint = Config::Theme::highlight_tint;
+}
+
+// generate the base sizes to be used to render the sprites and etc.
+void
+BoardRenderer::setLayout(const QSizeF& size,
+                         size_t        stack_amount,
+                         size_t        slice_amount,
+                         qreal         pixel_ratio)
+{
+    TRACE_SPAN("BoardRenderer::setLayout");
+
+    assert(stack_amount > 0 && stack_amount <= Config::STACK_MAX);
+
+    m_stack_amount = stack_amount;
+
+    m_geometry.window      = size;
+    m_geometry.pixel_ratio = pixel_ratio;
+
+    m_geometry.stack_area.setWidth(size.width() / stack_amount);
+    m_geometry.stack_area.setHeight(size.height() * 0.8F);
+
+    // boards with more slices than usual get thinner slices, so they fit
+    m_geometry.slice.setHeight(
+        (m_geometry.stack_area.height()
+         / std::max(Config::SLICE_MAX, slice_amount))
+        * 1.1F);
+
+    m_geometry.slice.setWidth(m_geometry.stack_area.width() * 0.9F);
+
+    m_geometry.stack_base.setWidth(m_geometry.slice.width() * 1.1F);
+    m_geometry.stack_base.setHeight(m_geometry.slice.height() * 0.5F);
+
+    m_geometry.dialog.setWidth(size.width() * 0.4F);
+    m_geometry.dialog.setHeight(size.height() * 0.2F);
+
+    m_geometry.stack_pole.setHeight(m_geometry.stack_area.height());
+    m_geometry.stack_pole.setWidth(m_geometry.stack_base.width() * 0.1F);
+
+    if (m_sprites.scaled.slices.size() < slice_amount) {
+        m_sprites.scaled.slices.resize(slice_amount);
+    }
+
+    // every label is lower than the one before it, so the slices drawn as
+    // spans are the labels from the first one that is too low
+    m_lod_label = 0;
+    while (m_lod_label < slice_amount
+           && sliceSize(m_lod_label).height() * pixel_ratio >= LOD_HEIGHT) {
+        m_lod_label++;
+    }
+
+    prepareStaticText();
+}
+
+// every slice has a different size, each one is scaled down from the one
+// below it
+QSizeF
+BoardRenderer::sliceSize(size_t label) const
+{
+    return QSizeF(
+        m_geometry.slice.width() * std::pow(Config::W_SCALE_FACTOR, label + 1),
+        m_geometry.slice.height()
+            * std::pow(Config::H_SCALE_FACTOR, label + 1));
+}
+
+// every stack owns a column of the board as wide as it's area
+size_t
+BoardRenderer::stackAt(const QPointF& point) const
+{
+    if (point.x() < 0 || point.y() < 0
+        || point.y() > m_geometry.window.height()
+        || m_geometry.stack_area.width() <= 0) {
+        return SIZE_MAX;
+    }
+
+    const size_t i = point.x() / m_geometry.stack_area.width();
+
+    return (i < m_stack_amount) ? i : SIZE_MAX;
+}
+
+void
+BoardRenderer::setStackTint(const QColor& color)
+{
+    if (m_sprites.stack_tint == color) { return; }
+
+    // drop the sprites of the old tint, they're made again when drawn
+    m_sprites.stack_base = QImage();
+    m_sprites.stack_pole = QImage();
+    m_sprites.scaled.stack_base = QImage();
+    m_sprites.scaled.stack_pole = QImage();
+
+    m_sprites.stack_tint = color;
+}
+
+void
+BoardRenderer::setSliceTint(const QColor& color)
+{
+    if (m_sprites.slice_tint == color) { return; }
+
+    // drop the sprites of the old tint, they're made again when drawn
+    m_sprites.slice = QImage();
+    for (QImage& scaled : m_sprites.scaled.slices) { scaled = QImage(); }
+
+    m_sprites.slice_tint = color;
+}
+
+// the label font depends on the pole width, so the labels only need to be
+// laid out again when the geometry changes
+void
+BoardRenderer::prepareStaticText()
+{
+    m_text.label_font
+        = QFont(Config::Theme::font_name,
+                std::max(1, int(m_geometry.stack_pole.width() * 0.9F)));
+
+    for (size_t i = 0; i < Config::STACK_MAX; i++) {
+        m_text.labels[i].setTextFormat(Qt::PlainText);
+        m_text.labels[i].setText(Utils::numToChar(i));
+        m_text.labels[i].prepare(QTransform(), m_text.label_font);
+    }
+
+    // the dialog text is laid out lazily, force it to be rebuilt
+    m_text.dialog_source.clear();
+}
+
+// scale a sprite to 'size' logical pixels at the current pixel ratio, the
+// result is kept in 'cache' and is only re-scaled when the size or the pixel
+// ratio (e.g. moving to a screen with another scale factor) has changed.
+// a sprite scaled by another board, or on a previous run, is taken from the
+// sprite cache instead.
+const QImage&
+BoardRenderer::scaledSprite(QImage&       cache,
+                            QImage&       tinted,
+                            const Asset&  asset,
+                            const QColor& tint,
+                            const QSizeF& size)
+{
+    const QSize device_size = (size * m_geometry.pixel_ratio).toSize();
+
+    if (!cache.isNull() && cache.size() == device_size
+        && cache.devicePixelRatio() == m_geometry.pixel_ratio) {
+        return cache;
+    }
+
+    const SpriteCache::Key key { asset.hash(),
+                                 tint.rgba(),
+                                 device_size,
+                                 m_geometry.pixel_ratio };
+
+    // another board with the same tint and size already has it
+    cache = SpriteCache::shared(key);
+    if (!cache.isNull()) { return cache; }
+
+    cache = SpriteCache::load(key);
+    if (!cache.isNull()) {
+        SpriteCache::share(key, cache);
+        return cache;
+    }
+
+    TRACE_SPAN("BoardRenderer::scaledSprite (miss)");
+
+    if (tinted.isNull()) { tinted = Utils::tintImage(asset.image(), tint); }
+
+    cache = tinted
+                .scaled(device_size,
+                        Qt::IgnoreAspectRatio,
+                        Qt::SmoothTransformation)
+                .convertToFormat(QImage::Format_ARGB32_Premultiplied);
+    cache.setDevicePixelRatio(m_geometry.pixel_ratio);
+
+    SpriteCache::share(key, cache);
+    SpriteCache::store(key, cache, &cache);
+
+    return cache;
+}
+
+// draws a single stack with all of it's slices.
+void
+BoardRenderer::drawStack(float           x_axis,
+                         HanoiStack*     stack,
+                         QPainter* const painter)
+{
+    TRACE_SPAN("BoardRenderer::drawStack");
+
+    assert(painter != nullptr);
+    assert(painter->isActive());
+
+    if (stack->isEmpty()) { return; }
+
+    float y_axis = m_geometry.window.height() - m_geometry.stack_base.height();
+
+    // a span is as wide as it's bottom slice, the widest one
+    const qreal span_min = 1 / m_geometry.pixel_ratio;
+    QRectF      span;
+    bool        in_span = false;
+
+    m_spans.clear();
+
+    stack->forEverySliceReversed([&](HanoiSlice*& slice) {
+        const size_t label = slice->getLabel();
+        const QSizeF size  = sliceSize(label);
+
+        if (label < m_lod_label) {
+            y_axis -= std::floor(size.height());
+
+            drawSlice(QPointF(x_axis - (size.width() * 0.5F), y_axis),
+                      label,
+                      painter);
+            return;
+        }
+
+        if (!in_span) {
+            in_span = true;
+            span    = QRectF(QPointF(x_axis - (size.width() * 0.5F), y_axis),
+                             QSizeF(size.width(), 0));
+        }
+
+        y_axis -= size.height();
+        span.setTop(y_axis);
+
+        if (span.height() >= span_min) {
+            m_spans.push_back(span);
+            in_span = false;
+        }
+    });
+
+    if (in_span) { m_spans.push_back(span); }
+
+    if (m_spans.empty()) { return; }
+
+    painter->save();
+    painter->setPen(Qt::NoPen);
+    painter->setBrush(m_sprites.slice_tint);
+    painter->drawRects(m_spans.data(), int(m_spans.size()));
+    painter->restore();
+}
+
+void
+BoardRenderer::drawSlice(const QPointF&  point,
+                         size_t          label,
+                         QPainter* const painter)
+{
+    TRACE_SPAN("BoardRenderer::drawSlice");
+
+    assert(label < m_sprites.scaled.slices.size());
+
+    if (label >= m_lod_label) {
+        painter->fillRect(QRectF(point, sliceSize(label)),
+                          m_sprites.slice_tint);
+        return;
+    }
+
+    painter->drawImage(point,
+                       scaledSprite(m_sprites.scaled.slices[label],
+                                    m_sprites.slice,
+                                    source().slice,
+                                    m_sprites.slice_tint,
+                                    sliceSize(label)));
+}
+
+// render the stack base
+void
+BoardRenderer::drawStackBase(float x_axis, QPainter* const painter)
+{
+    TRACE_SPAN("BoardRenderer::drawStackBase");
+
+    assert(painter != nullptr);
+    assert(painter->isActive());
+
+    // draw the pole
+    painter->drawImage(
+        QPointF(x_axis - (m_geometry.stack_pole.width() * 0.5F),
+                m_geometry.window.height() - m_geometry.stack_pole.height()),
+        scaledSprite(m_sprites.scaled.stack_pole,
+                     m_sprites.stack_pole,
+                     source().stack_pole,
+                     m_sprites.stack_tint,
+                     m_geometry.stack_pole));
+
+    // draw the base
+    painter->drawImage(
+        QPointF(x_axis - (m_geometry.stack_base.width() * 0.5F),
+                m_geometry.window.height() - m_geometry.stack_base.height()),
+        scaledSprite(m_sprites.scaled.stack_base,
+                     m_sprites.stack_base,
+                     source().stack_base,
+                     m_sprites.stack_tint,
+                     m_geometry.stack_base));
+}
+
+// render the stack label
+void
+BoardRenderer::drawStackLabel(size_t          label,
+                              float           x_axis,
+                              GoalMarker      marker,
+                              QPainter* const painter)
+{
+    TRACE_SPAN("BoardRenderer::drawStackLabel");
+
+    assert(painter != nullptr);
+    assert(painter->isActive());
+
+    const float pole_y
+        = m_geometry.window.height() - m_geometry.stack_pole.height();
+
+    const QRect label_box(x_axis
+                              - (m_geometry.stack_pole.width() * 0.5F),    // x
+                          pole_y - (m_geometry.stack_pole.width() * 2),    // y
+                          m_geometry.stack_pole.width(),                   // w
+                          m_geometry.stack_pole.width());                  // h
+
+    // draw the arrow (before the game starts) or the indicator
+    if (marker == GoalMarker::ARROW) {
+        const QSizeF arrow_size(
+            x_axis - m_geometry.stack_area.width() * 0.5F,    // w
+            m_geometry.stack_base.width() * 0.1F);            // h
+
+        const QImage& arrow_sprite = scaledSprite(m_sprites.scaled.arrow,
+                                                  m_sprites.arrow,
+                                                  source().arrow,
+                                                  m_sprites.arrow_tint,
+                                                  arrow_size);
+
+        assert(!arrow_sprite.isNull());
+
+        painter->drawImage(
+            QPointF(m_geometry.stack_area.width() * 0.5F,    // x
+                    pole_y - arrow_size.height()),           // y
+            arrow_sprite);
+    } else if (marker == GoalMarker::INDICATOR) {
+        painter->fillRect(label_box.x(),                           // x
+                          pole_y - (label_box.height() * 0.5F),    // y
+                          label_box.width(),                       // w
+                          label_box.height() * 0.2F,               // h
+                          Config::Theme().highlight_tint);
+    }
+
+    // draw the pre-laid-out stack label, centered above the pole
+    const QStaticText& text = m_text.labels[label];
+
+    painter->setFont(m_text.label_font);
+    painter->setPen(Config::Theme().font_color);
+    painter->drawStaticText(
+        QPointF(label_box.center().x() - (text.size().width() * 0.5F),
+                label_box.y()),
+        text);
+}
+
+void
+BoardRenderer::drawDialog(const QString&  text,
+                          const QColor&   color,
+                          QPainter* const painter)
+{
+    TRACE_SPAN("BoardRenderer::drawDialog");
+
+    // re-tint the dialog only when it's color or size has changed, the
+    // sprite is scaled to device pixels before tinting
+    const QSize device_size
+        = (m_geometry.dialog * m_geometry.pixel_ratio).toSize();
+
+    if (m_sprites.dialog_tint != color
+        || m_sprites.dialog.size() != device_size) {
+        const SpriteCache::Key key { source().dialog.hash(),
+                                     color.rgba(),
+                                     device_size,
+                                     m_geometry.pixel_ratio };
+
+        m_sprites.dialog = SpriteCache::shared(key);
+
+        if (m_sprites.dialog.isNull()) {
+            m_sprites.dialog = SpriteCache::load(key);
+        }
+
+        if (m_sprites.dialog.isNull()) {
+            m_sprites.dialog
+                = Utils::tintImage(
+                      source().dialog.image().scaled(device_size,
+                                                     Qt::IgnoreAspectRatio,
+                                                     Qt::SmoothTransformation),
+                      color)
+                      .convertToFormat(QImage::Format_ARGB32_Premultiplied);
+            m_sprites.dialog.setDevicePixelRatio(m_geometry.pixel_ratio);
+
+            SpriteCache::store(key, m_sprites.dialog, &m_sprites.dialog);
+        }
+
+        SpriteCache::share(key, m_sprites.dialog);
+
+        m_sprites.dialog_tint = color;
+    }
+
+    const QSize dialog_size = m_geometry.dialog.toSize();
+
+    // lay out the text only when it differs from the cached one
+    if (m_text.dialog_source != text) {
+        const int font_size
+            = std::max(1, int(dialog_size.width() / text.length()));
+
+        m_text.dialog_font = QFont(Config::Theme().font_name, font_size);
+        m_text.dialog.setTextFormat(Qt::PlainText);
+        m_text.dialog.setText(text);
+        m_text.dialog.prepare(QTransform(), m_text.dialog_font);
+        m_text.dialog_source = text;
+    }
+
+    painter->setFont(m_text.dialog_font);
+    painter->setPen(Config::Theme().font_color);
+
+    // setup bounds to make sure the text is centered
+    const QRect dialog_rect(
+        QPoint(
+            ((m_geometry.window.width() * 0.5F) - (dialog_size.width() * 0.5F)),
+            ((m_geometry.window.height() * 0.5F)
+             - (dialog_size.height() * 0.5F))),
+        dialog_size);
+
+    const QSizeF text_size = m_text.dialog.size();
+
+    const QPointF text_pos(
+        dialog_rect.center().x() - (text_size.width() * 0.5F),
+        dialog_rect.y()
+            + (dialog_rect.height() * 0.9F - text_size.height()) * 0.5F);
+
+    // render the dialog
+    painter->drawImage(dialog_rect, m_sprites.dialog);
+    painter->drawStaticText(text_pos, m_text.dialog);
+}
+
+// render the stacks and slices
+void
+BoardRenderer::drawBoard(HanoiStack*     stacks,
+                         size_t          goal,
+                         GoalMarker      marker,
+                         QPainter* const painter)
+{
+    TRACE_SPAN("BoardRenderer::drawBoard");
+
+    float x_offset = m_geometry.stack_area.width() * 0.5F;
+    for (size_t i = 0; i < m_stack_amount; i++) {
+        drawStackBase(x_offset, painter);
+        drawStackLabel(i,
+                       x_offset,
+                       (i == goal) ? marker : GoalMarker::NONE,
+                       painter);
+        drawStack(x_offset, &stacks[i], painter);
+        x_offset += m_geometry.stack_area.width();    // shift to the right
+    }
+}
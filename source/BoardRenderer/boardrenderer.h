@@ -0,0 +1,167 @@
+//-- Description -------------------------------------------------------------/
+// Renders a Hanoi board onto any paint device (a widget, or a QImage in a    /
+// worker thread). Holds the sizes, scaled sprites and laid-out text of one   /
+// board layout, so every view or export thread owns a renderer of it's own.  /
+//----------------------------------------------------------------------------/
+
+#ifndef BOARDRENDERER_H
+#define BOARDRENDERER_H
+
+#include "../Config/config.h"
+#include "../HanoiStack/hanoistack.h"
+
+#include <QColor>
+#include <QFont>
+#include <QImage>
+#include <QPainter>
+#include <QPointF>
+#include <QRectF>
+#include <QSizeF>
+#include <QStaticText>
+#include <QString>
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+class BoardRenderer {
+public:
+    // slices lower than this are drawn as solid spans instead of sprites,
+    // the shading of the sprite can't be seen on them (device pixels)
+    static constexpr qreal LOD_HEIGHT = 4;
+
+    BoardRenderer();
+
+    // decode the untinted sprites ahead of the first renderer, if the sprite
+    // cache is empty. can be called from any thread
+    static void preloadSprites();
+
+    // how the goal stack is marked
+    enum class GoalMarker {
+        NONE,
+        ARROW,        // arrow pointing at the goal stack
+        INDICATOR,    // bar under the goal stack label
+    };
+
+    // Stores the sizes of the board objects
+    struct Geometry {
+        QSizeF stack_area, stack_base, slice, dialog, window, stack_pole;
+
+        // device pixels per logical pixel the sizes are rendered at
+        qreal pixel_ratio = 1;
+    };
+
+    // recalculate the layout of a board of 'size' logical pixels
+    void setLayout(const QSizeF &size,
+                   size_t        stack_amount,
+                   size_t        slice_amount,
+                   qreal         pixel_ratio = 1);
+
+    // re-tint the stack/slice sprites, if the tint has changed
+    void setStackTint(const QColor &);
+    void setSliceTint(const QColor &);
+
+    inline const Geometry &geometry() const { return m_geometry; }
+
+    // get the size of the slice of 'label'
+    QSizeF sliceSize(size_t label) const;
+
+    // the label of the stack under a point, or SIZE_MAX
+    size_t stackAt(const QPointF &point) const;
+
+    // draws a single stack and also it's slices, the slices lower than
+    // LOD_HEIGHT are merged into spans at least a device pixel high
+    void drawStack(float, HanoiStack *, QPainter *const);
+
+    // draw the stack base/background
+    void drawStackBase(float, QPainter *const);
+
+    void drawStackLabel(size_t, float, GoalMarker, QPainter *const);
+
+    // draw the slice of 'label' with it's top left corner at a point
+    void drawSlice(const QPointF &, size_t label, QPainter *const);
+
+    // draw a dialog sprite in the center of the board
+    void drawDialog(const QString &, const QColor &, QPainter *const);
+
+    // draw every stack with it's label and slices
+    void drawBoard(HanoiStack *stacks,
+                   size_t      goal,
+                   GoalMarker  marker,
+                   QPainter *const);
+
+private:
+    // an untinted sprite, it's file is hashed up front but only decoded
+    // when a tinted copy of it isn't in the sprite cache
+    class Asset {
+    public:
+        explicit Asset(const char *path);
+
+        // decoded on the first call, thread-safe
+        const QImage &image() const;
+
+        uint64_t hash() const { return m_hash; }
+
+    private:
+        const char    *m_path;
+        uint64_t       m_hash = 0;
+        mutable QImage m_image;
+
+        mutable std::once_flag m_decoded;
+    };
+
+    // the untinted sprites, shared by every renderer
+    struct Source {
+        Asset stack_pole { Config::AssetsFiles::STACK_POLE };
+        Asset stack_base { Config::AssetsFiles::STACK_BASE };
+        Asset arrow { Config::AssetsFiles::ARROW };
+        Asset slice { Config::AssetsFiles::SLICE };
+        Asset dialog { Config::AssetsFiles::DIALOG };
+    };
+
+    static const Source &source();
+
+    // returns a sprite tinted and scaled to a logical size in device pixels,
+    // kept in 'cache'. it's looked up in the sprite cache before being built
+    // from 'tinted', the full size tinted sprite (made on first use)
+    const QImage &scaledSprite(QImage       &cache,
+                               QImage       &tinted,
+                               const Asset  &asset,
+                               const QColor &tint,
+                               const QSizeF &size);
+
+    // lay out the stack labels for the current geometry
+    void prepareStaticText();
+
+    Geometry m_geometry;
+    size_t   m_stack_amount = 0;
+
+    // the first label drawn as a solid span, every label after it is lower
+    size_t m_lod_label = SIZE_MAX;
+
+    // the spans of the stack being drawn, kept to reuse the allocation
+    std::vector<QRectF> m_spans;
+
+    // Stores the tinted sprites, and their copies scaled to device pixels.
+    // the full size tinted sprites are only made when a scaled one is not
+    // in the sprite cache
+    struct Sprites {
+        QColor stack_tint, slice_tint, arrow_tint, dialog_tint;
+        QImage stack_pole, stack_base, arrow, slice, dialog;
+
+        struct Scaled {
+            QImage              stack_pole, stack_base, arrow;
+            std::vector<QImage> slices;
+        } scaled;
+    } m_sprites;
+
+    // Stores text that is laid out once per layout change and reused by
+    // every paint, so no text shaping happens while rendering a frame
+    struct TextCache {
+        QFont       label_font, dialog_font;
+        QStaticText labels[Config::STACK_MAX];
+        QStaticText dialog;
+        QString     dialog_source;    // text 'dialog' holds
+    } m_text;
+};
+
+#endif    // BOARDRENDERER_H
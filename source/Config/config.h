@@ -9,8 +9,8 @@
 #include <QString>
 
 #ifndef DISABLE_AUDIO
-    #include <QAudioOutput>
-    #include <QSoundEffect>
+class MusicStream;
+class SfxMixer;
 #endif    // !DISABLE_AUDIO
 
 struct Config {
@@ -22,6 +22,8 @@ struct Config {
     static constexpr float         W_SCALE_FACTOR       = 0.9F;
     static constexpr char          DEFAULT_STACK_TINT[] = "#71391c";
     static constexpr char          DEFAULT_SLICE_TINT[] = "#7e1313";
+    static constexpr size_t        HISTORY_MEMORY_MAX   = size_t(1) << 20;
+    static constexpr size_t        MOVE_TREE_MAX        = size_t(1) << 16;
 
     // clang-format off
 
@@ -48,6 +50,7 @@ struct Config {
     struct Theme {
         static inline QString font_name               = "monospace";
         static inline QColor  font_color              = "#fffeee";
+        static inline QColor  background_tint         = "#343442";
         static inline QColor  highlight_tint          = "#e8d81c";
         static inline QColor  stack_tint              = DEFAULT_STACK_TINT;
         static inline QColor  slice_tint              = DEFAULT_SLICE_TINT;
@@ -63,14 +66,17 @@ struct Config {
         static inline float         fx_volume      = 1.0F;
         static inline float         music_volume   = 1.0F;
         static inline long long int time_length_ms = 60000 * 5;
+        static inline bool          history_spill  = true;    // to disk
+        static inline bool          sprite_cache   = true;    // on disk
     };
 
 #ifndef DISABLE_AUDIO
-    static inline QAudioOutput* m_bg_music_output = nullptr;
+    static inline MusicStream* m_bg_music  = nullptr;
+    static inline SfxMixer*    m_sfx_mixer = nullptr;
 
     struct AudioFiles {
-        static constexpr char PLACEMENT_FX[] = "qrc:/audio/placement_fx.wav";
-        static constexpr char BACKGROUND_MUSIC[] = "qrc:/audio/bg_music.wav";
+        static constexpr char PLACEMENT_FX[] = ":/audio/placement_fx.wav";
+        static constexpr char BACKGROUND_MUSIC[] = ":/audio/bg_music_adpcm.wav";
     };
 #endif    // !DISABLE_AUDIO
 };
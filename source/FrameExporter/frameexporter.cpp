@@ -0,0 +1,151 @@
+//-- Description -------------------------------------------------------------/
+// methods that replay moves on a private board and render every step of it  /
+// into a QImage, on as many threads as there are cores.                      /
+//----------------------------------------------------------------------------/
+
+#include "frameexporter.h"
+
+#include "../BoardRenderer/boardrenderer.h"
+#include "../Config/config.h"
+#include "../HanoiStack/hanoisolver.h"
+#include "../HanoiStack/hanoistack.h"
+#include "../Trace/trace.h"
+
+#include <QBuffer>
+#include <QByteArray>
+#include <QDir>
+#include <QFile>
+#include <QImage>
+#include <QPainter>
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <thread>
+
+std::vector<FrameExporter::Move>
+FrameExporter::getSolverMoves(const Options &options)
+{
+    const HanoiSolver solver(options.slice_amount, options.goal);
+
+    std::vector<Move> moves;
+    moves.reserve(solver.getMoveCount());
+
+    for (size_t i = 1; i <= solver.getMoveCount(); i++) {
+        moves.push_back(solver.getMove(i));
+    }
+
+    return moves;
+}
+
+bool
+FrameExporter::exportFrames(const Options           &options,
+                            const std::vector<Move> &moves)
+{
+    assert(options.stack_amount > 0);
+    assert(options.stack_amount <= Config::STACK_MAX);
+    assert(options.goal < options.stack_amount);
+
+    if (!QDir().mkpath(options.directory)) { return false; }
+
+    // the starting board, and one frame after every move
+    const size_t frame_count = moves.size() + 1;
+
+    size_t thread_amount = (options.threads > 0)
+                               ? options.threads
+                               : std::thread::hardware_concurrency();
+    thread_amount = std::clamp<size_t>(thread_amount, 1, frame_count);
+
+    // every worker gets a contiguous range of frames, so it only has to
+    // replay the moves before it's range once
+    const size_t range = (frame_count + thread_amount - 1) / thread_amount;
+
+    std::atomic_bool         failed = false;
+    std::vector<std::thread> workers;
+
+    for (size_t begin = 0; begin < frame_count; begin += range) {
+        const size_t end = std::min(begin + range, frame_count);
+
+        workers.emplace_back([&, begin, end]() {
+            TRACE_THREAD("frame export");
+            if (!exportRange(options, moves, begin, end)) { failed = true; }
+        });
+    }
+
+    for (std::thread &worker : workers) { worker.join(); }
+
+    return !failed;
+}
+
+bool
+FrameExporter::exportRange(const Options           &options,
+                           const std::vector<Move> &moves,
+                           size_t                   begin,
+                           size_t                   end)
+{
+    TRACE_SPAN("FrameExporter::exportRange");
+
+    // setup a private board
+    HanoiStack stacks[Config::STACK_MAX];
+    for (size_t i = 0; i < Config::STACK_MAX; i++) {
+        stacks[i] = HanoiStack(i);
+    }
+
+    HanoiStack::fillStack(&stacks[0], options.slice_amount);
+
+    // replay the moves leading up to the first frame
+    for (size_t i = 0; i < begin; i++) {
+        HanoiStack::makeLegalMove(&stacks[moves[i].first],
+                                  &stacks[moves[i].second]);
+    }
+
+    BoardRenderer renderer;
+    renderer.setLayout(QSizeF(options.frame_size),
+                       options.stack_amount,
+                       options.slice_amount);
+    renderer.setStackTint(Config::Theme::stack_tint);
+    renderer.setSliceTint(Config::Theme::slice_tint);
+
+    const QDir dir(options.directory);
+
+    QImage     frame(options.frame_size, QImage::Format_ARGB32_Premultiplied);
+    QByteArray encoded;
+
+    for (size_t i = begin; i < end; i++) {
+        if (i > 0) {
+            HanoiStack::makeLegalMove(&stacks[moves[i - 1].first],
+                                      &stacks[moves[i - 1].second]);
+        }
+
+        frame.fill(Config::Theme::background_tint);
+
+        QPainter painter(&frame);
+        renderer.drawBoard(stacks,
+                           options.goal,
+                           BoardRenderer::GoalMarker::INDICATOR,
+                           &painter);
+
+        if (stacks[options.goal].getSize() == options.slice_amount) {
+            renderer.drawDialog("SOLVER DONE",
+                                Config::Theme::solver_done_dialog_tint,
+                                &painter);
+        }
+        painter.end();
+
+        // encode in memory, then write the file with a single write
+        encoded.clear();
+        QBuffer buffer(&encoded);
+        buffer.open(QIODevice::WriteOnly);
+
+        if (!frame.save(&buffer, "PNG")) { return false; }
+
+        QFile file(dir.filePath(
+            QString("frame_%1.png").arg(qulonglong(i), 6, 10, QChar('0'))));
+
+        if (!file.open(QIODevice::WriteOnly)
+            || file.write(encoded) != encoded.size()) {
+            return false;
+        }
+    }
+
+    return true;
+}
@@ -0,0 +1,49 @@
+//-- Description -------------------------------------------------------------/
+// Renders a solver run, or any recorded sequence of moves, into a numbered   /
+// PNG image sequence without an on-screen GameView. Frames are rendered in   /
+// parallel, every worker thread owning it's own board and renderer.          /
+//----------------------------------------------------------------------------/
+
+#ifndef FRAMEEXPORTER_H
+#define FRAMEEXPORTER_H
+
+#include <QSize>
+#include <QString>
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+class FrameExporter {
+public:
+    // the pair of stack labels a move is made between
+    using Move = std::pair<size_t, size_t>;
+
+    // a solver run of n slices is 2^n frames, 65536 at most
+    static constexpr size_t SLICE_MAX = 16;
+
+    struct Options {
+        QString  directory;                       // output directory
+        QSize    frame_size   = QSize(1280, 720);
+        size_t   stack_amount = 3;
+        size_t   slice_amount = 5;
+        size_t   goal         = 2;    // label of the goal stack
+        unsigned threads      = 0;    // 0: one per core
+    };
+
+    // get the moves of a solver run for the board in 'options'
+    static std::vector<Move> getSolverMoves(const Options &options);
+
+    // render the starting board, and the board after every move, to
+    // 'directory'/frame_000000.png... returns false if a frame has failed
+    static bool exportFrames(const Options &options,
+                             const std::vector<Move> &moves);
+
+private:
+    // render and write the frames in [begin, end)
+    static bool exportRange(const Options           &options,
+                            const std::vector<Move> &moves,
+                            size_t                   begin,
+                            size_t                   end);
+};
+
+#endif    // FRAMEEXPORTER_H
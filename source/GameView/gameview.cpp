@@ -6,81 +6,63 @@
 #include "gameview.h"
 
 #include "../Config/config.h"
+#include "../Metrics/metrics.h"
 
 #ifndef DISABLE_AUDIO
-    #include <QSoundEffect>
+    #include "../Audio/sfxmixer.h"
 #endif    // !DISABLE_AUDIO
 
+#include <QDateTime>
 #include <QPainter>
 #include <QPixmap>
 #include <QPoint>
 #include <QTimer>
 
-QTimer GameView::TimeInfo::timer = QTimer();
-
 GameView::GameView(QWidget *parent) : QWidget { parent }
 {
-    // init timer.
-    // timer will call checkWinState every tick (should be every 1ms).
-    connect(&TimeInfo::timer, &QTimer::timeout, this, &GameView::checkWinState);
+    // init the clock timers, both are single shot and are only re-armed
+    // while the clock is running.
+    m_time.deadline.setSingleShot(true);
+    m_time.deadline.setTimerType(Qt::PreciseTimer);
+    m_time.tick.setSingleShot(true);
+    m_time.tick.setTimerType(Qt::PreciseTimer);
+
+    connect(&m_time.deadline,
+            &QTimer::timeout,
+            this,
+            &GameView::checkWinState);
+
+    connect(&m_time.tick,
+            &QTimer::timeout,
+            this,
+            &GameView::updateClockDisplay);
 
     for (size_t i = 0; i < Config::STACK_MAX; i++) {
-        HanoiStacks::stacks[i] = HanoiStack(i);
+        m_stacks.stacks[i]    = HanoiStack(i);
+        m_timeline.preview[i] = HanoiStack(i);
     }
 
-// load the placement sound effect
+    // accept keyboard input
+    setFocusPolicy(Qt::StrongFocus);
+
+// play the placement sound effect
 #ifndef DISABLE_AUDIO
-    m_placement_fx = new QSoundEffect(this);
-    m_placement_fx->setSource(QString(Config::AudioFiles::PLACEMENT_FX));
-    m_placement_fx->setVolume(Config::Settings::fx_volume);
-    connect(this, &GameView::s_slice_moved, [&]() { m_placement_fx->play(); });
-    assert(m_placement_fx->status() != QSoundEffect::Error);
+    connect(this, &GameView::s_slice_moved, []() {
+        if (Config::m_sfx_mixer != nullptr) {
+            Config::m_sfx_mixer->play(SfxMixer::Effect::PLACEMENT);
+        }
+    });
 #endif
 
-    GameSprites::stack_pole = new QPixmap();
-    GameSprites::stack_base = new QPixmap();
-    GameSprites::arrow      = new QPixmap();
-    GameSprites::slice      = new QPixmap();
-
-    // load arrow sprite ====================================================
-    GameSprites::arrow->load(Config::AssetsFiles::ARROW);
-    assert(!GameSprites::arrow->isNull());
-    colorizeSprite(GameSprites::arrow, Config::Theme().highlight_tint);
-
-    // load stack sprites ===================================================
-    GameSprites::stack_pole->load(Config::AssetsFiles::STACK_POLE);
-    GameSprites::stack_base->load(Config::AssetsFiles::STACK_BASE);
-
-    colorizeSprite(GameSprites::stack_base, Config::Theme::stack_tint);
-    colorizeSprite(GameSprites::stack_pole, Config::Theme::stack_tint);
-    GameSprites::stack_tint = Config::Theme::stack_tint;
+    m_renderer = new BoardRenderer();
 }
 
 GameView::~GameView()
 {
     if (has_solver_task()) { stop_solver_task(); }
-#ifndef DISABLE_AUDIO
-    delete m_placement_fx;
-#endif
-    delete GameSprites::stack_pole;
-    delete GameSprites::stack_base;
-    delete GameSprites::arrow;
-    delete GameSprites::slice;
+    delete m_renderer;
 }
 
-GameView *const &
-GameView::getInstance()
-{
-    static GameView *G = new GameView();
-    return G;
-};
-
-void
-GameView::destroyInstance()
-{
-    delete getInstance();
-};
-
 void
 GameView::solve()
 {
@@ -91,15 +73,19 @@ GameView::solve()
     // reset the stacks first
     clear();
 
-    // stop the timer if active
-    if (TimeInfo::timer.isActive()) { TimeInfo::timer.stop(); }
+    // stop the clock if running
+    stopClock();
 
     // set state to be running
     m_game_state = GameState::GAME_RUNNING;
 
+    m_time.started_at_ms = QDateTime::currentMSecsSinceEpoch();
+
     repaint();    // repaint first
 
     start_solver_task();    // start the solver in a new thread
+
+    updateTimerOut();
 }
 
 void
@@ -107,19 +93,19 @@ GameView::pause()
 {
     switch (m_game_state) {
         case GameState::GAME_PAUSED:
-            TimeInfo::timer.start(1);
-            updateInfo();
+            startClock();
             if (has_paused_solver_task()) { unpause_solver_task(); }
             m_game_state = GameState::GAME_RUNNING;
+            updateTimerOut();
             emit(s_unpaused());
             break;
         case GameState::GAME_RUNNING:
             if (has_solver_task()) { pause_solver_task(); }
-            if (!TimeInfo::timer.isActive()) { return; }
-            TimeInfo::timer.stop();
+            if (!m_time.running) { return; }
+            stopClock();
             m_game_state = GameState::GAME_PAUSED;
             emit(s_paused());
-            updateInfo();
+            updateTimerOut();
             break;
         default:
             return;
@@ -133,30 +119,28 @@ GameView::reset()
     // stop the solver process if present
     if (has_solver_task()) { stop_solver_task(); }
 
-    // reset some states
-    TimeInfo::elapsed = 0;
-    m_move_count      = 0;
+    Metrics::add(Metrics::Counter::RESETS);
 
-    m_redo_history.clear();
-    m_redo_history.clear();
+    // reset some states
+    m_move_count = 0;
 
-    // stop the timer (if any)
-    TimeInfo::timer.stop();
+    // stop the clock (if running)
+    resetClock();
 
     // clear the stacks, and resize if needed
     clear();
 
+    // a new game, every random choice is made from it's seed
+    m_seed      = m_next_seed != 0 ? m_next_seed : Random::nextGameSeed();
+    m_random    = Random(m_seed);
+    m_next_seed = 0;
+
     // set the goal stack
     setGoalStack();
 
     // update the sidebar
     updateInfo();
 
-#ifndef DISABLE_AUDIO
-    // set the fx volume
-    m_placement_fx->setVolume(Config::Settings::fx_volume);
-#endif
-
     m_game_state = GameState::GAME_RUNNING;
 
     emit(s_game_inactive());
@@ -167,51 +151,37 @@ GameView::reset()
 void
 GameView::undo()
 {
-    if (m_move_history.isEmpty()
+    m_timeline.target = SIZE_MAX;
+
+    if (has_solver_task()
         || (m_game_state != GameState::GAME_RUNNING
             && m_game_state != GameState::GAME_PAUSED)) {
         return;
     }
 
-    std::pair<HanoiStack *, HanoiStack *> move = m_move_history.getTop();
-
-    try {
-        move.first->push(move.second->pop());
-    } catch (...) {
-        return;
-    }
+    if (!revertMove()) { return; }
 
-    --m_move_count;
+    updateMoveCountOut();
 
     repaint();
-
-    m_redo_history.push(move);
-
-    m_move_history.pop();
 }
 
 void
 GameView::redo()
 {
-    if (m_redo_history.isEmpty()
+    m_timeline.target = SIZE_MAX;
+
+    if (has_solver_task() || !m_move_tree.canRedo()
         || (m_game_state != GameState::GAME_RUNNING
             && m_game_state != GameState::GAME_PAUSED)) {
         return;
     }
 
-    std::pair<HanoiStack *, HanoiStack *> move = m_redo_history.getTop();
+    if (!replayMove(m_move_tree.redoMove())) { return; }
 
-    try {
-        move.second->push(move.first->pop());
-    } catch (...) {
-        return;
-    }
-
-    ++m_move_count;
+    updateMoveCountOut();
 
     repaint();
 
-    m_move_history.push(move);
-
-    m_redo_history.pop();
+    checkWinState();
 }
@@ -5,26 +5,29 @@
 #ifndef GAMEVIEW_H
 #define GAMEVIEW_H
 
+#include "../BoardRenderer/boardrenderer.h"
 #include "../Config/config.h"
 #include "../HanoiStack/hanoistack.h"
-#include "../Utils/Stack.h"
+#include "../MoveHistory/boardsnapshots.h"
+#include "../MoveHistory/movehistory.h"
+#include "../MoveHistory/movetree.h"
+#include "../Random/random.h"
 
 #include <QCoreApplication>
+#include <QElapsedTimer>
 #include <QLabel>
 #include <QPainter>
 #include <QPushButton>
-#include <QTextEdit>
+#include <QSlider>
 #include <QTime>
 #include <QTimer>
 #include <QWidget>
 #include <atomic>
+#include <deque>
+#include <mutex>
 #include <thread>
 #include <utility>
-
-#ifndef DISABLE_AUDIO
-    #include <QSoundEffect>
-    #include <QtMultimedia>
-#endif
+#include <vector>
 
 class GameView : public QWidget {
     Q_OBJECT
@@ -43,104 +46,166 @@ public slots:
 
     void redo();
 
-private:
-    explicit GameView(QWidget *parent = nullptr);
+    // show/hide the frame-time and throughput overlay
+    void togglePerfOverlay();
 
-public:
-    GameView(GameView &&) = delete;
+    // queue moves written in stack notation (e.g. "AB AC BC"), the whole
+    // string is rejected if any of it is invalid
+    bool enterMoves(const QString &notation);
 
-    // create & return gameview instance
-    static GameView *const &getInstance();
+    // save the current game to a replay file
+    bool saveReplay(const QString &path);
+
+    // load a game from a replay file, and continue it from it's last move
+    bool loadReplay(const QString &path);
+
+    // show the board after the first 'move' moves, without changing the game
+    void seekTimeline(int move);
+
+    // continue the game from the move shown by the timeline, a solver run
+    // or a finished game is only viewed
+    void commitTimeline();
+
+public:
+    // every view is a separate game, only the sprites are shared
+    explicit GameView(QWidget *parent = nullptr);
 
-    // destroy gameview instance
-    static void destroyInstance();
+    GameView(GameView &&) = delete;
 
     ~GameView() override;
 
     // define pointers to the output widgets
-    static void
-    setSidebarWidget(QPushButton *, QLabel *, QLabel *, QTextEdit *);
+    void
+    setSidebarWidget(QPushButton *, QLabel *, QLabel *, QLabel *);
+
+    // define the pointer to the timeline slider
+    void setTimelineWidget(QSlider *);
 
 private slots:
-    // called by timer in every ms
+    // called after every move, and when the time limit is reached
     void checkWinState();
 
-private:
-    static inline size_t m_move_count = 0;
-
-#ifndef DISABLE_AUDIO
-    QSoundEffect *m_placement_fx = nullptr;
-#endif
+    // called by the clock timer when the shown second changes
+    void updateClockDisplay();
 
-    // =======================================================================
+    // execute every queued move, then redraw once
+    void flushMoveQueue();
 
-    // Stores game sprites
-    struct GameSprites {
-        static inline QColor   stack_tint, slice_tint;
-        static inline QPixmap *stack_pole = nullptr, *stack_base = nullptr,
-                              *arrow = nullptr, *slice = nullptr;
-    };
+private:
+    size_t m_move_count = 0;
 
     // =======================================================================
 
-    // Stores game object sizes
-    struct Geometry {
-        static inline QSizeF stack_area, stack_base, slice, dialog, window,
-            stack_pole;
-    };
+    // Renders the board, holds the sizes and the scaled sprites
+    BoardRenderer *m_renderer = nullptr;
 
     // =======================================================================
 
     // Stores the current slice and it's source stack selected
     struct SelectedSlice {
-        static inline HanoiStack *stack = nullptr;    // source stack
-        static inline HanoiSlice *slice = nullptr;    // selected slice
-        static inline float       x = 0, y = 0;
+        HanoiStack *stack = nullptr;    // source stack
+        HanoiSlice *slice = nullptr;    // selected slice
+        float       x = 0, y = 0;
 
-        static inline bool hasSelected()
+        bool hasSelected() const
         {
             return stack != nullptr && slice != nullptr;
         }
 
-        // move slice stored by SelectedSlice:: to the QPoints x and y values
-        static inline void move(const QPoint &point)
+        // move the selected slice to the QPoints x and y values
+        void move(const QPoint &point)
         {
-            x = (point.x() - (SelectedSlice::slice->Width() * 0.5F));
-            y = (point.y() - (SelectedSlice::slice->Height() * 0.5F));
+            x = (point.x() - (slice->Width() * 0.5F));
+            y = (point.y() - (slice->Height() * 0.5F));
         }
-    };
+    } m_selected;
 
     // =======================================================================
 
-    // Stores the Sidebar Widget instances
+    // Stores the Sidebar Widget instances, and the values they show
     struct SidebarWidgets {
-        static inline QLabel *move_count_out    = nullptr,
-                             *info_msg_label    = nullptr;
-        static inline QPushButton *timer_out    = nullptr;
-        static inline QTextEdit   *info_msg_out = nullptr;
-    };
+        QLabel *move_count_out = nullptr, *info_msg_label = nullptr,
+               *info_msg_out = nullptr;
+
+        QPushButton *timer_out = nullptr;
+
+        QString shown_time;
+        size_t  shown_move_count = SIZE_MAX;
+        size_t  shown_goal       = SIZE_MAX;
+    } m_sidebar;
+
+    // =======================================================================
+
+    // Stores the moves entered from the keyboard, waiting to be executed.
+    // a flush is scheduled when the queue becomes non-empty, so any amount
+    // of moves entered before the next event loop pass share a single redraw
+    struct MoveQueue {
+        std::deque<std::pair<size_t, size_t>> pending;
+
+        // stack typed as the source of the next move, or SIZE_MAX
+        size_t typed_source = SIZE_MAX;
+
+        bool flush_scheduled = false;
+    } m_move_queue;
+
+    // =======================================================================
+
+    // Stores the board snapshots the timeline seeks from, and the board it
+    // shows while it's away from the current move. a seek loads the closest
+    // snapshot and replays at most BoardSnapshots::INTERVAL - 1 moves from
+    // the history, only when a frame is painted.
+    struct Timeline {
+        // taken by the solver thread while it records a move
+        std::mutex lock;
+
+        BoardSnapshots snapshots;
+
+        QSlider *slider = nullptr;
+
+        size_t target = SIZE_MAX;    // SIZE_MAX: the live board
+        size_t shown  = SIZE_MAX;    // move the preview holds
+
+        HanoiStack preview[Config::STACK_MAX];
+
+        bool isActive() const { return target != SIZE_MAX; }
+    } m_timeline;
 
     // =======================================================================
 
     // Stores the stacks and slices of the game
     struct HanoiStacks {
         // all slices in game
-        static inline HanoiSlice *slices[Config::SLICE_MAX];
+        HanoiSlice *slices[Config::SLICE_MAX] = {};
 
         // all stack in game
-        static inline HanoiStack stacks[Config::STACK_MAX];
+        HanoiStack stacks[Config::STACK_MAX];
 
         // points to the target stack in the game
-        static inline HanoiStack *goal_stack = nullptr;
-    };
+        HanoiStack *goal_stack = nullptr;
+    } m_stacks;
 
     // =======================================================================
 
-    // Stores the QTimer instances and time elapsed
+    // Stores the game clock. the elapsed time is taken from a monotonic
+    // clock, timers are only used for the time limit and for refreshing
+    // the display once every second
     struct TimeInfo {
-        static QTimer               timer;
-        static inline long long int elapsed = 0;    // ms
-    };
+        QTimer deadline;    // fires when the time limit is reached
+        QTimer tick;        // fires when the shown second changes
+
+        QElapsedTimer clock;
+        long long int banked  = 0;    // ms, before last start
+        bool          running = false;
+
+        // wall clock time of the first move, ms since the unix epoch
+        long long int started_at_ms = 0;
+
+        // ms elapsed while the clock was running
+        long long int elapsed() const
+        {
+            return banked + (running ? clock.elapsed() : 0);
+        }
+    } m_time;
 
     // =======================================================================
 
@@ -154,19 +219,60 @@ private:
     };
 
     // Stores the current game state
-    static inline GameState m_game_state = GameState::GAME_INACTIVE;
+    GameState m_game_state = GameState::GAME_INACTIVE;
+
+    // seed of the current game, drawn from the session on reset, and the
+    // generator of the game's random choices
+    uint64_t m_seed = 0;
+    Random   m_random;
 
-    static inline Stack<std::pair<HanoiStack *, HanoiStack *>> m_move_history;
-    static inline Stack<std::pair<HanoiStack *, HanoiStack *>> m_redo_history;
+    // used by the next reset instead of a drawn seed, 0: none (a replay
+    // continues the game it was saved from)
+    uint64_t m_next_seed = 0;
+
+    // moves made by the player or the solver, on the line that is played
+    MoveHistory m_history;
+
+    // every line the player has tried, undo/redo and branch switching
+    // walk over it
+    MoveTree m_move_tree;
 
     // =======================================================================
 
     // Stores the Solver Task thread instance and state
     struct SolverTask {
-        static inline std::atomic_bool stop_solving  = false;
-        static inline std::atomic_bool pause_solving = false;
-        static inline std::thread     *work_thread   = nullptr;
-    };
+        std::atomic_bool stop_solving  = false;
+        std::atomic_bool pause_solving = false;
+        std::thread     *work_thread   = nullptr;
+    } m_solver;
+
+    // Stores the performance counters shown by the overlay, the paint and
+    // sidebar timings are only taken while the overlay is enabled
+    struct PerfOverlay {
+        static constexpr size_t HISTORY = 120;    // frames
+
+        bool   enabled           = false;
+        float  paint_ms[HISTORY] = {};
+        size_t paint_index = 0, paint_count = 0;
+        float  update_info_ms    = 0;
+
+        // counted from the gui and the solver thread
+        std::atomic_size_t moves            = 0;
+        std::atomic_size_t solver_moves     = 0;
+        std::atomic_size_t pending_repaints = 0;
+
+        // per second rates, sampled once every second
+        QElapsedTimer rate_timer;
+        size_t        rate_frames = 0, rate_moves = 0, rate_solver_moves = 0;
+        float         fps = 0, moves_per_s = 0, solver_moves_per_s = 0;
+    } m_perf;
+
+    // store the paint time of a frame for the overlay and the metrics, and
+    // re-sample the rates
+    void recordPaint(qint64 ns);
+
+    // draw the performance overlay in the top left corner
+    void drawPerfOverlay(QPainter *const);
 
     // Handles Solver Thread ================================================
 
@@ -177,19 +283,79 @@ private:
     void start_solver_task();
 
     // check if a task is already running
-    static bool has_solver_task();
+    bool has_solver_task();
 
     // check if the solver task is paused
-    static bool has_paused_solver_task();
+    bool has_paused_solver_task();
 
     // halt the solver loop, and return from thread
-    static void stop_solver_task();
+    void stop_solver_task();
 
     // halt the solver loop
-    static void pause_solver_task();
+    void pause_solver_task();
 
     // un-halt the solver loop
-    static void unpause_solver_task();
+    void unpause_solver_task();
+
+    // Game Clock ============================================================
+
+    // start/resume the game clock
+    void startClock();
+
+    // halt the game clock, keeping the elapsed time
+    void stopClock();
+
+    // halt the game clock, and set the elapsed time to zero
+    void resetClock();
+
+    // Move Queue ============================================================
+
+    // parse stack notation into (source, dest) labels
+    static bool parseMoveNotation(const QString                        &,
+                                  std::vector<std::pair<size_t, size_t>> &);
+
+    // append moves to the queue, and schedule a flush
+    void queueMoves(const std::vector<std::pair<size_t, size_t>> &);
+
+    // drop the queued moves and the typed source
+    void clearMoveQueue();
+
+    // book-keeping after a player move from 'source' to 'dest'
+    void recordMove(HanoiStack *const source, HanoiStack *const dest);
+
+    // Move Tree =============================================================
+
+    // revert the last move, on the board and in the histories
+    bool revertMove();
+
+    // make a move, on the board and in the histories
+    bool replayMove(const MoveTree::Move &move);
+
+    // jump to the last position of the next/previous branch
+    void switchBranch(bool next);
+
+    // hash of the current board, matches the move tree's hash
+    uint64_t boardHash();
+
+    // Timeline ==============================================================
+
+    // save a snapshot if the move just recorded is on the interval, and drop
+    // the snapshots of the moves that were discarded. called after every
+    // move is recorded with what MoveHistory::record() returned, with
+    // m_timeline.lock held on the solver thread
+    void recordSnapshot(bool is_new);
+
+    // forget the snapshots, and take the one of the starting board
+    void resetTimeline();
+
+    // rebuild the preview board at 'move'
+    void buildPreview(size_t move);
+
+    // update the range and the position of the timeline slider
+    void updateTimelineOut();
+
+    // schedule the next display refresh, to when the shown second changes
+    void scheduleClockTick();
 
     // Reset =================================================================
 
@@ -197,13 +363,13 @@ private:
     void clear();    // reset the game states
 
     // clear & reset all stack
-    static void resetStacks();
+    void resetStacks();
 
     // clear & reset all stack
-    static void resetSlices();
+    void resetSlices();
 
     // generate a random goal stack
-    static void setGoalStack();
+    void setGoalStack();
 
     // Scaling ===============================================================
 
@@ -211,23 +377,10 @@ private:
     void calculateBaseSizes();
 
     // handles slice scaling
-    static void scaleSlices();
+    void scaleSlices();
 
     // handles stack scaling
-    static void scaleStack();
-
-    // Drawing/Rendering =====================================================
-
-    // draws a single stack and also it's slices
-    static void drawStack(float, HanoiStack *, QPainter *const);
-
-    // draw the stack base/background
-    static void drawStackBase(float, QPainter *const);
-
-    static void drawStackLabel(size_t, float, QPainter *const);
-
-    // draw a dialog sprite in the center of the screen
-    static void drawDialog(const QString &, const QColor &, QPainter *const);
+    void scaleStack();
 
     // Input Event ===========================================================
 
@@ -240,6 +393,9 @@ private:
     // on mouse movement
     void mouseMoveEvent(QMouseEvent *const) override;
 
+    // on key press
+    void keyPressEvent(QKeyEvent *const) override;
+
     // Widget events =========================================================
 
     // widget repaint event
@@ -256,28 +412,39 @@ private:
 
     // =======================================================================
 
-    static bool clickInBounds(const QPoint &);
+    bool clickInBounds(const QPoint &);
 
-    // calculate click area, returns stack under click
-    static HanoiStack *calculateStackByPos(const QPointF &);
+    // calculate click area, returns stack under click or nullptr
+    HanoiStack *calculateStackByPos(const QPointF &);
 
-    // updates sidebar values
-    static void updateInfo();
+    // updates all sidebar values, only changed values are pushed
+    void updateInfo();
 
-    // get pointer to stack of 'label'
-    static HanoiStack *getStack(size_t label);
+    // updates the time left, called when the shown second changes
+    void updateTimerOut();
 
-    // tints pixmaps
-    static void colorizeSprite(QPixmap *const, const QColor &);
+    // updates the move counter, called after a move
+    void updateMoveCountOut();
+
+    // updates the objective, called on reset
+    void updateObjectiveOut();
+
+    // save the time spent updating the sidebar for the perf overlay
+    void recordSidebarUpdate(const QElapsedTimer &);
+
+    // get pointer to stack of 'label'
+    HanoiStack *getStack(size_t label);
 
-    // move/pop the top slice of a stack
-    static void makeLegalMove(HanoiStack *const source, HanoiStack *const dest);
+    // move the top slice between two stacks in the legal direction, returns
+    // the (source, dest) labels of the move made
+    std::pair<size_t, size_t> makeLegalMove(HanoiStack *const a,
+                                            HanoiStack *const b);
 
-    // generate random stack index from 1 to n-1
-    static size_t getRandomGoalStackIndex();
+    // generate random stack index from 1 to n-1, from the game's seed
+    size_t getRandomGoalStackIndex();
 
     // check if the goal stack has all valid slices in it
-    static bool goalStackIsComplete();
+    bool goalStackIsComplete();
 
     // check if a move from 'source' to 'dest' stack is possible
     static inline bool moveisLegal(const HanoiStack &source,
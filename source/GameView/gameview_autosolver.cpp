@@ -5,6 +5,13 @@
 #include "gameview.h"
 
 #include "../Config/config.h"
+#include "../HanoiStack/hanoisolver.h"
+#include "../Metrics/metrics.h"
+#include "../Trace/trace.h"
+
+#ifndef DISABLE_AUDIO
+    #include "../Audio/sfxmixer.h"
+#endif    // !DISABLE_AUDIO
 
 #include <chrono>
 #include <thread>
@@ -12,58 +19,68 @@
 void
 GameView::hanoiIterativeSolver()
 {
-    const size_t slice_amount = Config::Settings().slice_amount;
-    const size_t possible_moves
-        = (1 << slice_amount) - 1;    // (2^slice_amount) -1
-
-    // starting stack
-    const size_t source = 0;
-
-    // the goal of the slices
-    size_t dest = HanoiStacks::goal_stack->getLabel();
-
-    // this should be either the slice after the first one,
-    // or the slice after the goal stack
-    size_t aux = (dest == 1) ? dest + 1 : 1;
-
-    assert(dest != aux);
-    assert(source != dest);
-    assert(source != aux);
-
-    // swap dest with aux if
-    // slice_amount is an even number
-    if (slice_amount % 2 == 0) {
-        size_t tmp;
-        tmp  = dest;
-        dest = aux;
-        aux  = tmp;
-    }
+    TRACE_THREAD("solver");
+
+    // starts from stack 0, the goal is the goal stack
+    const HanoiSolver solver(Config::Settings().slice_amount,
+                             m_stacks.goal_stack->getLabel());
+
+    const size_t possible_moves = solver.getMoveCount();
 
-    for (int i = 1; i <= possible_moves && !SolverTask::stop_solving; i++) {
+    for (size_t i = 1; i <= possible_moves && !m_solver.stop_solving; i++) {
         // pauses the loop in place
-        while (SolverTask::pause_solving) {
+        while (m_solver.pause_solving) {
             std::this_thread::sleep_for(std::chrono::milliseconds(1));
-            if (SolverTask::stop_solving) { return; }
+            if (m_solver.stop_solving) { return; }
         }
 
-        // main algorithm
-        if (i % 3 == 0) {
-            makeLegalMove(getStack(aux), getStack(dest));
-        } else if (i % 3 == 1) {
-            makeLegalMove(getStack(source), getStack(dest));
-        } else {
-            makeLegalMove(getStack(source), getStack(aux));
-        }
-
-        ++m_move_count;
-
-        // redraw screeen
-        QMetaObject::invokeMethod(this, "repaint", Qt::QueuedConnection);
-
-        if (goalStackIsComplete()) {
-            m_game_state = GameState::GAME_OVER_SOLVER_DONE;
-            emit(s_game_over());
-            break;
+        // the delay is left out of the span
+        {
+            TRACE_SPAN("GameView::hanoiIterativeSolver (iteration)");
+
+            // main algorithm
+            const auto move = solver.getMove(i);
+
+            {
+                // the timeline reads the history from the gui thread
+                std::lock_guard<std::mutex> guard(m_timeline.lock);
+
+                const auto made = makeLegalMove(getStack(move.first),
+                                                getStack(move.second));
+
+                recordSnapshot(m_history.record(made.first, made.second));
+            }
+
+#ifndef DISABLE_AUDIO
+            // a single atomic add, the mixer merges the moves that come faster
+            // than the effect can be heard
+            if (Config::m_sfx_mixer != nullptr) {
+                Config::m_sfx_mixer->play(SfxMixer::Effect::PLACEMENT);
+            }
+#endif
+
+            ++m_move_count;
+            ++m_perf.moves;
+            ++m_perf.solver_moves;
+            Metrics::add(Metrics::Counter::MOVES);
+            Metrics::add(Metrics::Counter::SOLVER_MOVES);
+
+            // redraw screeen
+            ++m_perf.pending_repaints;
+            QMetaObject::invokeMethod(
+                this,
+                [this]() {
+                    --m_perf.pending_repaints;
+                    updateMoveCountOut();
+                    repaint();
+                },
+                Qt::QueuedConnection);
+
+            if (goalStackIsComplete()) {
+                m_game_state = GameState::GAME_OVER_SOLVER_DONE;
+                emit(s_game_over());
+                break;
+            }
         }
 
         // wait for some time
@@ -80,13 +97,13 @@ GameView::hanoiIterativeSolver()
 bool
 GameView::has_solver_task()
 {
-    return SolverTask::work_thread != nullptr;
+    return m_solver.work_thread != nullptr;
 }
 
 bool
 GameView::has_paused_solver_task()
 {
-    return has_solver_task() && SolverTask::pause_solving;
+    return has_solver_task() && m_solver.pause_solving;
 }
 
 // starts or stops the solver task
@@ -95,21 +112,21 @@ GameView::stop_solver_task()
 {
     assert(has_solver_task());
 
-    SolverTask::stop_solving = true;
+    m_solver.stop_solving = true;
 
     // wait for the thread to exit
-    if (SolverTask::work_thread->joinable()) {
-        SolverTask::work_thread->join();
+    if (m_solver.work_thread->joinable()) {
+        m_solver.work_thread->join();
     }
 
     // de-allocate the thread
-    delete SolverTask::work_thread;
+    delete m_solver.work_thread;
 
     // reset the states
-    SolverTask::pause_solving = false;
-    SolverTask::stop_solving  = false;
+    m_solver.pause_solving = false;
+    m_solver.stop_solving  = false;
 
-    SolverTask::work_thread = nullptr;
+    m_solver.work_thread = nullptr;
 }
 
 void
@@ -118,7 +135,7 @@ GameView::start_solver_task()
     assert(!has_solver_task());
 
     // start the thread;
-    SolverTask::work_thread
+    m_solver.work_thread
         = new std::thread(&GameView::hanoiIterativeSolver, this);
 }
 
@@ -128,12 +145,12 @@ void
 GameView::unpause_solver_task()
 {
     assert(has_paused_solver_task());
-    SolverTask::pause_solving = false;
+    m_solver.pause_solving = false;
 }
 
 void
 GameView::pause_solver_task()
 {
     assert(!has_paused_solver_task());
-    SolverTask::pause_solving = true;
+    m_solver.pause_solving = true;
 }
@@ -0,0 +1,68 @@
+//-- Description -------------------------------------------------------------/
+// methods that handle the game clock. the time is read from a monotonic     /
+// clock when needed, so no timer has to tick while the game is running.     /
+//----------------------------------------------------------------------------/
+
+#include "gameview.h"
+
+#include "../Config/config.h"
+
+#include <algorithm>
+
+// start or resume the clock, (re-)arms the deadline and the display timer
+void
+GameView::startClock()
+{
+    if (!m_time.running) {
+        m_time.clock.start();
+        m_time.running = true;
+    }
+
+    const long long int remaining = std::max(
+        0LL, Config::Settings::time_length_ms - m_time.elapsed());
+
+    m_time.deadline.start(int(remaining));
+
+    scheduleClockTick();
+}
+
+void
+GameView::stopClock()
+{
+    if (m_time.running) {
+        m_time.banked += m_time.clock.elapsed();
+        m_time.running = false;
+    }
+
+    m_time.deadline.stop();
+    m_time.tick.stop();
+}
+
+void
+GameView::resetClock()
+{
+    stopClock();
+    m_time.banked = 0;
+}
+
+// the display shows whole seconds of the remaining time, so it only has to
+// change when the remaining time crosses a second
+void
+GameView::scheduleClockTick()
+{
+    const long long int remaining
+        = Config::Settings::time_length_ms - m_time.elapsed();
+
+    if (remaining <= 0) { return; }
+
+    m_time.tick.start(int(remaining % 1000) + 1);
+}
+
+void
+GameView::updateClockDisplay()
+{
+    if (!m_time.running) { return; }
+
+    updateTimerOut();
+    scheduleClockTick();
+}
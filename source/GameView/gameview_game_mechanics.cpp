@@ -4,8 +4,9 @@
 //----------------------------------------------------------------------------/
 
 #include "../Config/config.h"
+#include "../Metrics/metrics.h"
+#include "../Trace/trace.h"
 #include "gameview.h"
-#include <random>
 
 // get the pointer to a stack
 HanoiStack *
@@ -14,31 +15,122 @@ GameView::getStack(size_t label)
     assert(label >= 0);
     assert(label < Config::Settings::stack_amount);
 
-    return &HanoiStacks::stacks[label];
+    return &m_stacks.stacks[label];
 }
 
 // move the top slice between two stacks
-void
-GameView::makeLegalMove(HanoiStack *const source, HanoiStack *const dest)
+std::pair<size_t, size_t>
+GameView::makeLegalMove(HanoiStack *const a, HanoiStack *const b)
 {
-    assert(source != nullptr);
-    assert(dest != nullptr);
-    assert((!dest->isEmpty()) || (!source->isEmpty()));
-
-    if (moveisLegal(*source, *dest)) {
-        dest->push(source->pop());
-    } else if (moveisLegal(*dest, *source)) {
-        source->push(dest->pop());
-    }
+    return HanoiStack::makeLegalMove(a, b);
 }
 
 // check a move from source to dest is legal/possible
 bool
 GameView::moveisLegal(const HanoiStack &source, const HanoiStack &dest)
 {
-    return !source.isEmpty()
-           && (dest.isEmpty()
-               || source.peek()->getLabel() > dest.peek()->getLabel());
+    return HanoiStack::isLegalMove(source, dest);
+}
+
+// the move tree and the history hold the same line, a mismatch means the
+// history has dropped the move
+bool
+GameView::revertMove()
+{
+    if (!m_move_tree.canUndo() || !m_history.canUndo()) { return false; }
+
+    const MoveTree::Move move = m_move_tree.undoMove();
+
+    if (m_history.undoMove() != move
+        || HanoiStack::tryMove(getStack(move.second), getStack(move.first))
+               != HanoiStack::MoveStatus::OK) {
+        return false;
+    }
+
+    m_move_tree.stepBack();
+    m_history.stepBack();
+
+    m_timeline.shown = SIZE_MAX;
+
+    --m_move_count;
+    ++m_perf.moves;
+    Metrics::add(Metrics::Counter::MOVES);
+
+    assert(boardHash() == m_move_tree.hash());
+
+    return true;
+}
+
+// a move already in the tree is followed, instead of adding a new node
+bool
+GameView::replayMove(const MoveTree::Move &move)
+{
+    HanoiStack *const source = getStack(move.first);
+    HanoiStack *const dest   = getStack(move.second);
+
+    if (HanoiStack::tryMove(source, dest) != HanoiStack::MoveStatus::OK) {
+        return false;
+    }
+
+    m_move_tree.record(move.first, move.second, dest->peek()->getLabel());
+    recordSnapshot(m_history.record(move.first, move.second));
+
+    ++m_move_count;
+    ++m_perf.moves;
+    Metrics::add(Metrics::Counter::MOVES);
+
+    assert(boardHash() == m_move_tree.hash());
+
+    return true;
+}
+
+// undo to the fork, then replay the other branch, the board is only redrawn
+// once at the end
+void
+GameView::switchBranch(bool next)
+{
+    if (has_solver_task() || m_selected.hasSelected()
+        || (m_game_state != GameState::GAME_RUNNING
+            && m_game_state != GameState::GAME_PAUSED)) {
+        return;
+    }
+
+    const MoveTree::NodeId target = m_move_tree.siblingBranch(next);
+    if (target == MoveTree::NONE) { return; }
+
+    m_timeline.target = SIZE_MAX;
+
+    size_t                      undo_count = 0;
+    std::vector<MoveTree::Move> redo;
+    m_move_tree.pathTo(target, undo_count, redo);
+
+    for (size_t i = 0; i < undo_count; i++) {
+        if (!revertMove()) { break; }
+    }
+
+    for (const MoveTree::Move &move : redo) {
+        if (!replayMove(move)) { break; }
+    }
+
+    updateMoveCountOut();
+
+    repaint();
+
+    checkWinState();
+}
+
+uint64_t
+GameView::boardHash()
+{
+    uint64_t hash = 0;
+
+    for (size_t i = 0; i < Config::Settings::stack_amount; i++) {
+        getStack(i)->forEverySlice([&](HanoiSlice *&slice) {
+            hash ^= MoveTree::sliceHash(slice->getLabel(), i);
+        });
+    }
+
+    return hash;
 }
 
 // generate a random stack label for the goal stack
@@ -48,33 +140,34 @@ GameView::getRandomGoalStackIndex()
     static constexpr size_t min = 1;
     const size_t            max = Config::Settings::stack_amount - 1;
 
-    std::random_device rdev;
-    std::mt19937       gen(rdev());
-
-    std::uniform_int_distribution<size_t> distr(min, max);
-
-    return distr(gen);
+    return m_random.range(min, max);
 }
 
-// check the win state, is called by the timer every 1ms
+// check the win state, is called after every move and by the deadline timer
 void
 GameView::checkWinState()
 {
-    if (TimeInfo::timer.isActive()) {
-        TimeInfo::elapsed++;
-        updateInfo();
-    }
+    TRACE_SPAN("GameView::checkWinState");
+
+    if (m_game_state != GameState::GAME_RUNNING) { return; }
 
     if (goalStackIsComplete()) {
         m_game_state = GameState::GAME_OVER_WON;
-        TimeInfo::timer.stop();
+        Metrics::add(Metrics::Counter::GAMES_WON);
+        stopClock();
         emit(s_game_over());
+        updateTimerOut();
         repaint();
-    } else if (TimeInfo::elapsed >= Config::Settings::time_length_ms) {
+    } else if (m_time.elapsed() >= Config::Settings::time_length_ms) {
         m_game_state = GameState::GAME_OVER_LOST;
-        TimeInfo::timer.stop();
+        Metrics::add(Metrics::Counter::GAMES_LOST);
+        stopClock();
         emit(s_game_over());
+        updateTimerOut();
         repaint();
+    } else if (m_time.running && !m_time.deadline.isActive()) {
+        // woken up early, wait for the rest of the time
+        startClock();
     }
 }
 
@@ -82,6 +175,6 @@ GameView::checkWinState()
 bool
 GameView::goalStackIsComplete()
 {
-    return (HanoiStacks::goal_stack->getSize()
+    return (m_stacks.goal_stack->getSize()
             == Config::Settings::slice_amount);
 }
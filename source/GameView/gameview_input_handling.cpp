@@ -4,11 +4,16 @@
 
 #include "gameview.h"
 
+#include <QClipboard>
+#include <QFileDialog>
+#include <QGuiApplication>
+#include <QKeyEvent>
 #include <QMouseEvent>
-#include <stdexcept>
 #include <utility>
 
 #include "../Config/config.h"
+#include "../Metrics/metrics.h"
+#include "../Trace/trace.h"
 
 // on mouse press, pop the slice of the stack below the mouse click,
 // and store it.
@@ -17,27 +22,20 @@ GameView::mousePressEvent(QMouseEvent* const event)
 {
     if (has_solver_task()) return;
 
-    if (SelectedSlice::hasSelected() || m_game_state != GameState::GAME_RUNNING
-        || !clickInBounds(event->pos())) {
+    if (m_selected.hasSelected() || m_game_state != GameState::GAME_RUNNING
+        || m_timeline.isActive() || !clickInBounds(event->pos())) {
         return;
     }
 
-    HanoiStack* clicked_stack = nullptr;
-    if (event->button() == Qt::LeftButton) {
-        try {
-            clicked_stack = calculateStackByPos(event->pos().toPointF());
-            if (clicked_stack->isEmpty()) { return; }
-        } catch (...) {
-            return;
-        }
-    } else {
-        return;
-    }
+    if (event->button() != Qt::LeftButton) { return; }
+
+    HanoiStack* clicked_stack = calculateStackByPos(event->position());
+    if (clicked_stack == nullptr || clicked_stack->isEmpty()) { return; }
 
-    SelectedSlice::slice = clicked_stack->pop();
-    SelectedSlice::stack = clicked_stack;
+    m_selected.slice = clicked_stack->pop();
+    m_selected.stack = clicked_stack;
 
-    SelectedSlice::move(event->pos());
+    m_selected.move(event->pos());
     update();
 }
 
@@ -48,12 +46,12 @@ GameView::mouseMoveEvent(QMouseEvent* const event)
 {
     if (has_solver_task()) return;
 
-    if (!SelectedSlice::hasSelected() || m_game_state != GameState::GAME_RUNNING
+    if (!m_selected.hasSelected() || m_game_state != GameState::GAME_RUNNING
         || !clickInBounds(event->pos())) {
         return;
     }
 
-    SelectedSlice::move(event->pos());
+    m_selected.move(event->pos());
     update();
 }
 
@@ -64,75 +62,130 @@ GameView::mouseReleaseEvent(QMouseEvent* const event)
 {
     if (has_solver_task()) return;
 
-    if (!SelectedSlice::hasSelected()
+    if (!m_selected.hasSelected()
         || m_game_state != GameState::GAME_RUNNING) {
         return;
     }
 
-    HanoiStack* destination_stack = nullptr;
-    try {
-        destination_stack = calculateStackByPos(event->position().toPoint());
-        destination_stack->push(SelectedSlice::slice);
-    } catch (...) {
-        SelectedSlice::stack->push(SelectedSlice::slice);
-        SelectedSlice::stack = nullptr;
-        SelectedSlice::slice = nullptr;
+    HanoiStack* destination_stack = calculateStackByPos(event->position());
+
+    // put the slice back if it's dropped out of bounds, on it's own stack,
+    // or on top of a smaller slice
+    if (destination_stack == nullptr
+        || destination_stack == m_selected.stack
+        || destination_stack->tryPush(m_selected.slice)
+               != HanoiStack::MoveStatus::OK) {
+        // only a drop on top of a smaller slice is an illegal move
+        if (destination_stack != nullptr
+            && destination_stack != m_selected.stack) {
+            Metrics::add(Metrics::Counter::ILLEGAL_MOVES);
+        }
+
+        m_selected.stack->tryPush(m_selected.slice);
+        m_selected.stack = nullptr;
+        m_selected.slice = nullptr;
         update();
         return;
     }
 
-    // increment the move counter
-    m_move_count++;
-
-    if (!m_redo_history.isEmpty()) { m_redo_history.clear(); }
+    recordMove(m_selected.stack, destination_stack);
+    updateMoveCountOut();
 
-    // save the move (source, dest)
-    m_move_history.push(
-        std::make_pair(SelectedSlice::stack, destination_stack));
+    m_selected.stack = nullptr;
+    m_selected.slice = nullptr;
 
-    // start the timer
-    if (m_game_state == GameState::GAME_RUNNING
-        && !TimeInfo::timer.isActive()) {
-        TimeInfo::timer.start(1);
-        emit(s_game_started());
-    }
-
-    SelectedSlice::stack = nullptr;
-    SelectedSlice::slice = nullptr;
+    // check if this move has won the game
+    checkWinState();
 
     update();
 
     emit(s_slice_moved());
 }
 
-// compare the QPointF x and y values to a stack's area, if
-// if said point is in a stack's area, return the pointer
-// to the stack
-HanoiStack*
-GameView::calculateStackByPos(const QPointF& point)
+// on key press, handle the keyboard shortcuts. typing two stack labels
+// (e.g. 'A' then 'C') moves a slice, and pasting queues a whole notation.
+void
+GameView::keyPressEvent(QKeyEvent* const event)
 {
-    const float stack_area_height = Geometry::window.height();
-    const float stack_area_width  = Geometry::stack_area.width();
+    if (event->key() == Qt::Key_F3) {
+        togglePerfOverlay();
+        return;
+    }
 
-    float area_width = stack_area_width;
+#ifdef HANOI_TRACE
+    if (event->key() == Qt::Key_F4) {
+        Trace::dump();
+        return;
+    }
+#endif    // HANOI_TRACE
 
-    for (size_t i = 0; i < Config::Settings::stack_amount; i++) {
-        const float x = (point.x() != 0) ? (point.x() / area_width) : 0;
-        const float y = (point.y() != 0) ? (point.y() / stack_area_height) : 0;
+    if (event->matches(QKeySequence::Paste)) {
+        enterMoves(QGuiApplication::clipboard()->text());
+        return;
+    }
 
-        if ((x >= 0 && x <= 1) && (y >= 0 && y <= 1)) { return getStack(i); }
+    if (event->matches(QKeySequence::Save)) {
+        const QString path = QFileDialog::getSaveFileName(
+            this, "Save Replay", QString(), "Hanoi Replay (*.hnr)");
+        if (!path.isEmpty()) { saveReplay(path); }
+        return;
+    }
 
-        area_width += stack_area_width;
+    if (event->matches(QKeySequence::Open)) {
+        const QString path = QFileDialog::getOpenFileName(
+            this, "Load Replay", QString(), "Hanoi Replay (*.hnr)");
+        if (!path.isEmpty()) { loadReplay(path); }
+        return;
     }
 
-    throw std::runtime_error(
-        "GameView::calculateStackByPos(): point is out of bounds");
+    if (event->key() == Qt::Key_BracketLeft
+        || event->key() == Qt::Key_BracketRight) {
+        switchBranch(event->key() == Qt::Key_BracketRight);
+        return;
+    }
+
+    if (event->key() == Qt::Key_Escape) {
+        m_move_queue.typed_source = SIZE_MAX;
+        return;
+    }
+
+    const size_t label = event->key() - Qt::Key_A;
+
+    if (event->key() < Qt::Key_A || label >= Config::Settings::stack_amount
+        || (event->modifiers() & ~Qt::ShiftModifier) != 0) {
+        QWidget::keyPressEvent(event);
+        return;
+    }
+
+    if (m_move_queue.typed_source == SIZE_MAX) {
+        m_move_queue.typed_source = label;
+        return;
+    }
+
+    // the second label completes the move, typing the same label twice
+    // cancels it
+    if (m_move_queue.typed_source != label) {
+        queueMoves({ std::make_pair(m_move_queue.typed_source, label) });
+    }
+
+    m_move_queue.typed_source = SIZE_MAX;
+}
+
+// every stack area has the same width, so the stack under a point is found
+// by dividing it's x value by the width. returns nullptr if the point is out
+// of bounds.
+HanoiStack*
+GameView::calculateStackByPos(const QPointF& point)
+{
+    const size_t i = m_renderer->stackAt(point);
+
+    return (i != SIZE_MAX) ? getStack(i) : nullptr;
 }
 
 bool
 GameView::clickInBounds(const QPoint& p)
 {
     return (p.x() >= 0 && p.y() >= 0)
-           && (p.x() < Geometry::window.width()
-               && p.y() < Geometry::window.height());
+           && (p.x() < m_renderer->geometry().window.width()
+               && p.y() < m_renderer->geometry().window.height());
 }
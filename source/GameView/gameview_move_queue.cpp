@@ -0,0 +1,180 @@
+//-- Description -------------------------------------------------------------/
+// methods that handle moves entered from the keyboard. moves are parsed and  /
+// validated up front, then executed from a queue in one pass per frame.      /
+//----------------------------------------------------------------------------/
+
+#include "gameview.h"
+
+#include "../Config/config.h"
+#include "../Metrics/metrics.h"
+#include "../Utils/utils.h"
+
+#include <QDateTime>
+#include <QTimer>
+
+bool
+GameView::enterMoves(const QString &notation)
+{
+    if (has_solver_task() || m_selected.hasSelected()
+        || m_game_state != GameState::GAME_RUNNING) {
+        return false;
+    }
+
+    std::vector<std::pair<size_t, size_t>> moves;
+
+    if (!parseMoveNotation(notation, moves)) {
+        qWarning("GameView::enterMoves(): invalid move notation");
+        return false;
+    }
+
+    m_move_queue.typed_source = SIZE_MAX;
+    queueMoves(moves);
+
+    return true;
+}
+
+// every move is a pair of stack labels, the letters may be separated by
+// whitespace, ',', '-' or '>' (e.g. "AB AC", "A C", "A->B, B->C")
+bool
+GameView::parseMoveNotation(const QString                          &notation,
+                            std::vector<std::pair<size_t, size_t>> &moves)
+{
+    std::vector<std::pair<size_t, size_t>> parsed;
+    parsed.reserve(notation.size() / 2);
+
+    size_t source = SIZE_MAX;
+
+    for (const QChar c : notation) {
+        if (c.isSpace() || c == ',' || c == '-' || c == '>') { continue; }
+
+        const char16_t letter = c.toUpper().unicode();
+        const size_t   label  = letter - u'A';
+
+        if (letter < u'A' || label >= Config::Settings::stack_amount) {
+            return false;
+        }
+
+        if (source == SIZE_MAX) {
+            source = label;
+            continue;
+        }
+
+        if (source == label) { return false; }
+
+        parsed.emplace_back(source, label);
+        source = SIZE_MAX;
+    }
+
+    // a dangling source label is an incomplete move
+    if (source != SIZE_MAX || parsed.empty()) { return false; }
+
+    moves.insert(moves.end(), parsed.begin(), parsed.end());
+    return true;
+}
+
+void
+GameView::queueMoves(const std::vector<std::pair<size_t, size_t>> &moves)
+{
+    m_move_queue.pending.insert(
+        m_move_queue.pending.end(), moves.begin(), moves.end());
+    Metrics::set(Metrics::Gauge::MOVE_QUEUE_DEPTH,
+                 int64_t(m_move_queue.pending.size()));
+
+    if (m_move_queue.flush_scheduled || m_move_queue.pending.empty()) {
+        return;
+    }
+
+    m_move_queue.flush_scheduled = true;
+    QTimer::singleShot(0, this, &GameView::flushMoveQueue);
+}
+
+void
+GameView::clearMoveQueue()
+{
+    m_move_queue.pending.clear();
+    m_move_queue.typed_source = SIZE_MAX;
+    Metrics::set(Metrics::Gauge::MOVE_QUEUE_DEPTH, 0);
+}
+
+// execute the queued moves in order, the sidebar, the redraw and the sound
+// effect are done once for the whole batch. an illegal move drops the rest
+// of the queue, as the moves after it were entered for another board.
+void
+GameView::flushMoveQueue()
+{
+    m_move_queue.flush_scheduled = false;
+
+    if (has_solver_task() || m_selected.hasSelected()
+        || m_timeline.isActive() || m_game_state != GameState::GAME_RUNNING) {
+        clearMoveQueue();
+        return;
+    }
+
+    size_t executed = 0;
+
+    while (!m_move_queue.pending.empty()
+           && m_game_state == GameState::GAME_RUNNING) {
+        const std::pair<size_t, size_t> move = m_move_queue.pending.front();
+        m_move_queue.pending.pop_front();
+
+        HanoiStack *const source = getStack(move.first);
+        HanoiStack *const dest   = getStack(move.second);
+
+        if (HanoiStack::tryMove(source, dest) != HanoiStack::MoveStatus::OK) {
+            qWarning("GameView::flushMoveQueue(): illegal move %s%s, "
+                     "dropped %zu queued moves",
+                     qPrintable(Utils::numToChar(move.first)),
+                     qPrintable(Utils::numToChar(move.second)),
+                     m_move_queue.pending.size());
+            Metrics::add(Metrics::Counter::ILLEGAL_MOVES);
+            m_move_queue.pending.clear();
+            break;
+        }
+
+        recordMove(source, dest);
+        ++executed;
+
+        // stops the loop if this move has won the game
+        checkWinState();
+    }
+
+    // the game is over, the rest of the queue can't be executed
+    if (m_game_state != GameState::GAME_RUNNING) { clearMoveQueue(); }
+
+    Metrics::set(Metrics::Gauge::MOVE_QUEUE_DEPTH,
+                 int64_t(m_move_queue.pending.size()));
+
+    if (executed == 0) { return; }
+
+    updateMoveCountOut();
+
+    update();
+
+    emit(s_slice_moved());
+}
+
+// count the move, save it to the history, and start the clock on the first
+// move of the game
+void
+GameView::recordMove(HanoiStack *const source, HanoiStack *const dest)
+{
+    m_move_count++;
+    ++m_perf.moves;
+    Metrics::add(Metrics::Counter::MOVES);
+
+    // save the move, the undone moves are kept as a branch of the tree
+    recordSnapshot(m_history.record(source->getLabel(), dest->getLabel()));
+    m_move_tree.record(
+        source->getLabel(), dest->getLabel(), dest->peek()->getLabel());
+
+    assert(boardHash() == m_move_tree.hash());
+
+    // start the clock
+    if (m_game_state == GameState::GAME_RUNNING && !m_time.running) {
+        if (m_time.elapsed() == 0) {
+            m_time.started_at_ms = QDateTime::currentMSecsSinceEpoch();
+        }
+        startClock();
+        emit(s_game_started());
+    }
+}
@@ -0,0 +1,139 @@
+//-- Description -------------------------------------------------------------/
+// methods that collect and draw the frame-time and throughput overlay        /
+//----------------------------------------------------------------------------/
+
+#include "gameview.h"
+
+#include "../Config/config.h"
+#include "../Metrics/metrics.h"
+#include "../Startup/startup.h"
+#include "../Trace/trace.h"
+
+#include <QPainter>
+#include <algorithm>
+
+void
+GameView::togglePerfOverlay()
+{
+    m_perf.enabled = !m_perf.enabled;
+
+    // start a fresh sample
+    m_perf.paint_index       = m_perf.paint_count = 0;
+    m_perf.rate_frames       = 0;
+    m_perf.rate_moves        = m_perf.moves;
+    m_perf.rate_solver_moves = m_perf.solver_moves;
+    m_perf.rate_timer.start();
+
+    update();
+}
+
+void
+GameView::recordPaint(qint64 ns)
+{
+    if (Metrics::isEnabled()) { Metrics::observePaint(ns); }
+
+    if (!m_perf.enabled) { return; }
+
+    m_perf.paint_ms[m_perf.paint_index] = ns / 1e6F;
+    m_perf.paint_index = (m_perf.paint_index + 1) % PerfOverlay::HISTORY;
+    m_perf.paint_count
+        = std::min(m_perf.paint_count + 1, PerfOverlay::HISTORY);
+
+    ++m_perf.rate_frames;
+
+    // re-sample the rates every second
+    const qint64 elapsed = m_perf.rate_timer.elapsed();
+    if (elapsed < 1000) { return; }
+
+    const size_t moves        = m_perf.moves;
+    const size_t solver_moves = m_perf.solver_moves;
+    const float  seconds      = elapsed / 1000.0F;
+
+    m_perf.fps         = m_perf.rate_frames / seconds;
+    m_perf.moves_per_s = (moves - m_perf.rate_moves) / seconds;
+    m_perf.solver_moves_per_s
+        = (solver_moves - m_perf.rate_solver_moves) / seconds;
+
+    m_perf.rate_frames       = 0;
+    m_perf.rate_moves        = moves;
+    m_perf.rate_solver_moves = solver_moves;
+    m_perf.rate_timer.restart();
+}
+
+void
+GameView::drawPerfOverlay(QPainter* const painter)
+{
+    TRACE_SPAN("GameView::drawPerfOverlay");
+
+    assert(painter != nullptr);
+    assert(painter->isActive());
+
+    // percentiles of the recorded paint times
+    float sorted[PerfOverlay::HISTORY];
+    const size_t count = m_perf.paint_count;
+    std::copy(m_perf.paint_ms, m_perf.paint_ms + count, sorted);
+    std::sort(sorted, sorted + count);
+
+    const auto percentile = [&](float p) {
+        return (count > 0) ? sorted[size_t((count - 1) * p)] : 0.0F;
+    };
+
+    const QString text
+        = QString("paint  p50 %1  p95 %2  max %3 ms\n"
+                  "fps %4  moves/s %5  solver moves/s %6\n"
+                  "queued repaints %7  updateInfo %8 ms\n"
+                  "startup: first frame %9 ms\n"
+                  "seed %10")
+              .arg(percentile(0.5F), 0, 'f', 2)
+              .arg(percentile(0.95F), 0, 'f', 2)
+              .arg(percentile(1.0F), 0, 'f', 2)
+              .arg(m_perf.fps, 0, 'f', 1)
+              .arg(m_perf.moves_per_s, 0, 'f', 1)
+              .arg(m_perf.solver_moves_per_s, 0, 'f', 1)
+              .arg(qulonglong(m_perf.pending_repaints))
+              .arg(m_perf.update_info_ms, 0, 'f', 3)
+              .arg(Startup::timeToFirstFrameMs(), 0, 'f', 1)
+              .arg(qulonglong(m_seed), 16, 16, QChar('0'));
+
+    static constexpr int   padding   = 6;
+    static constexpr int   graph_h   = 40;
+    static constexpr float graph_max = 33.3F;    // ms, two 60hz frames
+
+    painter->save();
+
+    painter->setFont(QFont(Config::Theme::font_name, 9));
+
+    const QRect text_rect = painter->boundingRect(
+        QRect(padding, padding, 0, 0), Qt::AlignLeft | Qt::TextDontClip, text);
+
+    const QRect box(0,
+                    0,
+                    std::max<int>(text_rect.width(), PerfOverlay::HISTORY * 2)
+                        + padding * 2,
+                    text_rect.height() + graph_h + padding * 3);
+
+    painter->fillRect(box, QColor(0, 0, 0, 180));
+
+    painter->setPen(Config::Theme::font_color);
+    painter->drawText(text_rect, Qt::AlignLeft, text);
+
+    // rolling histogram of the paint times, oldest frame on the left
+    const int graph_bottom = box.height() - padding;
+    for (size_t i = 0; i < count; i++) {
+        const size_t index = (m_perf.paint_index + PerfOverlay::HISTORY
+                              - count + i)
+                             % PerfOverlay::HISTORY;
+
+        const float ms = m_perf.paint_ms[index];
+        const int   h  = std::min(1.0F, ms / graph_max) * graph_h;
+
+        painter->fillRect(padding + int(i) * 2,
+                          graph_bottom - std::max(h, 1),
+                          2,
+                          std::max(h, 1),
+                          (ms > 16.7F) ? Config::Theme::lose_dialog_tint
+                                       : Config::Theme::win_dialog_tint);
+    }
+
+    painter->restore();
+}
@@ -0,0 +1,94 @@
+//-- Description -------------------------------------------------------------/
+// methods that save the current game to a replay file, and load one back    /
+//----------------------------------------------------------------------------/
+
+#include "gameview.h"
+
+#include "../Config/config.h"
+#include "../Replay/replay.h"
+
+#include <algorithm>
+
+bool
+GameView::saveReplay(const QString &path)
+{
+    if (m_stacks.goal_stack == nullptr) { return false; }
+
+    std::vector<Replay::Move> moves;
+
+    if (has_solver_task() || !m_history.moves(moves)) {
+        qWarning("GameView::saveReplay(): the move history is not complete");
+        return false;
+    }
+
+    Replay::Info info;
+    info.stack_amount  = Config::Settings::stack_amount;
+    info.slice_amount  = Config::Settings::slice_amount;
+    info.goal          = m_stacks.goal_stack->getLabel();
+    info.result        = uint8_t(m_game_state);
+    info.seed          = m_seed;
+    info.started_at_ms = m_time.started_at_ms;
+    info.duration_ms   = m_time.elapsed();
+    info.time_limit_ms = Config::Settings::time_length_ms;
+
+    return Replay::save(path, info, moves);
+}
+
+// the board is set up with the replay's configuration, and every move is
+// made again so it can be undone. the clock continues from the saved time.
+bool
+GameView::loadReplay(const QString &path)
+{
+    Replay replay;
+
+    if (!replay.open(path)) {
+        qWarning("GameView::loadReplay(): '%s' is not a valid replay",
+                 qPrintable(path));
+        return false;
+    }
+
+    const Replay::Info &info = replay.info();
+
+    // everything is checked before a setting is changed, so a corrupt
+    // replay leaves the current game as it is
+    std::vector<Replay::Move> moves;
+
+    if (!replay.moves(moves)) {
+        qWarning("GameView::loadReplay(): '%s' has an illegal move",
+                 qPrintable(path));
+        return false;
+    }
+
+    if (info.time_limit_ms < Config::TIMER_MIN) {
+        qWarning("GameView::loadReplay(): '%s' has an invalid time limit",
+                 qPrintable(path));
+        return false;
+    }
+
+    Config::Settings::stack_amount   = info.stack_amount;
+    Config::Settings::slice_amount   = info.slice_amount;
+    Config::Settings::time_length_ms = info.time_limit_ms;
+
+    // 0 for a replay saved without a seed, the reset draws one
+    m_next_seed = info.seed;
+
+    reset();
+
+    m_stacks.goal_stack = getStack(info.goal);
+
+    for (const Replay::Move &move : moves) {
+        if (!replayMove(move)) { break; }
+    }
+
+    m_time.started_at_ms = info.started_at_ms;
+    m_time.banked        = std::max<long long>(0, info.duration_ms);
+
+    updateInfo();
+
+    // ends the game if it was already over
+    checkWinState();
+
+    repaint();
+
+    return true;
+}
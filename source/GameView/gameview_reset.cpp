@@ -14,6 +14,13 @@ GameView::clear()
     // get the base sizes for rendering
     calculateBaseSizes();
 
+    // drop the moves that were not executed yet, and the history
+    clearMoveQueue();
+    m_history.clear();
+    m_history.setSpill(Config::Settings::history_spill);
+    m_move_tree.reset(Config::Settings::slice_amount);
+    resetTimeline();
+
     // reset the stacks/slices
     resetStacks();
     resetSlices();
@@ -42,11 +49,11 @@ void
 GameView::resetSlices()
 {
     // reset the slice array
-    std::memset(&HanoiStacks::slices, 0, Config::Settings::slice_amount);
+    std::memset(&m_stacks.slices, 0, Config::Settings::slice_amount);
 
     // save the slices to the array
     getStack(0)->forEverySlice([&](HanoiSlice *&slice) {
-        HanoiStacks::slices[slice->getLabel()] = slice;
+        m_stacks.slices[slice->getLabel()] = slice;
     });
 
     // setup the sprite scaling
@@ -63,8 +70,8 @@ GameView::setGoalStack()
     assert(goalStackLabel < Config::Settings::stack_amount);
 
     // save the address of the stack
-    HanoiStacks::goal_stack = getStack(goalStackLabel);
+    m_stacks.goal_stack = getStack(goalStackLabel);
 
-    assert(HanoiStacks::goal_stack != nullptr);
-    assert(HanoiStacks::goal_stack->getLabel() == goalStackLabel);
+    assert(m_stacks.goal_stack != nullptr);
+    assert(m_stacks.goal_stack->getLabel() == goalStackLabel);
 }
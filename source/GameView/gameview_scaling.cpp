@@ -6,82 +6,51 @@
 #include "gameview.h"
 
 #include "../Config/config.h"
+#include "../Trace/trace.h"
 
 // generate the base sizes to be used to render the sprites and etc.
 void
 GameView::calculateBaseSizes()
 {
-    Geometry::window = this->size();
+    TRACE_SPAN("GameView::calculateBaseSizes");
 
-    Geometry::stack_area.setWidth(float(width())
-                                  / Config::Settings::stack_amount);
-
-    Geometry::stack_area.setHeight(height() * 0.8F);
-
-    Geometry::slice.setHeight(
-        (Geometry::stack_area.height() / Config::SLICE_MAX) * 1.1F);
-
-    Geometry::slice.setWidth(Geometry::stack_area.width() * 0.9F);
-
-    Geometry::stack_base.setWidth(Geometry::slice.width() * 1.1F);
-    Geometry::stack_base.setHeight(Geometry::slice.height() * 0.5F);
-
-    Geometry::dialog.setWidth(width() * 0.4F);
-    Geometry::dialog.setHeight(height() * 0.2F);
-
-    Geometry::stack_pole.setHeight(Geometry::stack_area.height());
-    Geometry::stack_pole.setWidth(Geometry::stack_base.width() * 0.1F);
+    m_renderer->setLayout(size(),
+                          Config::Settings::stack_amount,
+                          Config::Settings::slice_amount,
+                          devicePixelRatioF());
 }
 
 void
 GameView::scaleStack()
 {
-    // check for sprite tint change
-    if (GameSprites::stack_tint != Config::Theme::stack_tint) {
-        // reload the sprites
-        GameSprites::stack_pole->load(Config::AssetsFiles::STACK_POLE);
-        GameSprites::stack_base->load(Config::AssetsFiles::STACK_BASE);
-
-        assert(!GameSprites::stack_pole->isNull());
-        assert(!GameSprites::stack_base->isNull());
-
-        // tint the sprites
-        colorizeSprite(GameSprites::stack_base, Config::Theme::stack_tint);
-        colorizeSprite(GameSprites::stack_pole, Config::Theme::stack_tint);
+    TRACE_SPAN("GameView::scaleStack");
 
-        // save the color
-        GameSprites::stack_tint = Config::Theme::stack_tint;
-    }
+    // re-tints the sprites only if the tint has changed
+    m_renderer->setStackTint(Config::Theme::stack_tint);
 }
 
 void
 GameView::scaleSlices()
 {
-    // load and tint a new slice sprite if needed
-    if (GameSprites::slice_tint != Config::Theme::slice_tint) {
-        GameSprites::slice->load(Config::AssetsFiles::SLICE);
-
-        assert(!GameSprites::slice->isNull());
+    TRACE_SPAN("GameView::scaleSlices");
 
-        // tint the slice sprite
-        colorizeSprite(GameSprites::slice, Config::Theme::slice_tint);
-
-        // save the color
-        GameSprites::slice_tint = Config::Theme::slice_tint;
-    }
-
-    float width = Geometry::slice.width(), height = Geometry::slice.height();
+    // re-tints the sprite only if the tint has changed
+    m_renderer->setSliceTint(Config::Theme::slice_tint);
 
     // every slice has a different size
     for (size_t i = 0; i < Config::Settings::slice_amount; i++) {
-        HanoiStacks::slices[i]->Height() = (height *= Config::H_SCALE_FACTOR);
-        HanoiStacks::slices[i]->Width()  = (width *= Config::W_SCALE_FACTOR);
+        const QSizeF size = m_renderer->sliceSize(i);
+
+        m_stacks.slices[i]->Height() = size.height();
+        m_stacks.slices[i]->Width()  = size.width();
     }
 }
 
 void
 GameView::resizeEvent(QResizeEvent* event)
 {
+    TRACE_SPAN("GameView::resizeEvent");
+
     calculateBaseSizes();
     if (m_game_state != GameState::GAME_INACTIVE) {
         scaleStack();
@@ -1,67 +1,120 @@
 //-- Description -------------------------------------------------------------/
-// methods that handles the updating of data on the sidebar                   /
+// methods that handles the updating of data on the sidebar. every output     /
+// remembers the value it shows, and a widget is only touched on a change.   /
 //----------------------------------------------------------------------------/
 
+#include "../Trace/trace.h"
 #include "../Utils/utils.h"
 
 #include "../Config/config.h"
 
 #include "gameview.h"
 #include <QPushButton>
+#include <algorithm>
+#include <cstdint>
 
 void
 GameView::setSidebarWidget(QPushButton *time,
                            QLabel      *moves,
                            QLabel      *info_box_label,
-                           QTextEdit   *info_box)
+                           QLabel      *info_box)
 {
-    SidebarWidgets::timer_out      = time;
-    SidebarWidgets::move_count_out = moves;
-    SidebarWidgets::info_msg_out   = info_box;
-    SidebarWidgets::info_msg_label = info_box_label;
+    m_sidebar.timer_out      = time;
+    m_sidebar.move_count_out = moves;
+    m_sidebar.info_msg_out   = info_box;
+    m_sidebar.info_msg_label = info_box_label;
+
+    // forget the shown values
+    m_sidebar.shown_time.clear();
+    m_sidebar.shown_move_count = SIZE_MAX;
+    m_sidebar.shown_goal       = SIZE_MAX;
 }
 
-// update the Game's sidebar information
-// the current time is calculated from subtracting the start time with a
-// time elapsed counter.
+// update every output of the sidebar
 void
 GameView::updateInfo()
 {
-    if (SidebarWidgets::timer_out != nullptr) {
-        if (m_game_state == GameState::GAME_PAUSED) {
-            SidebarWidgets::timer_out->setText(" PAUSED ");
-        } else if (has_solver_task()) {
-            SidebarWidgets::timer_out->setText("--:--:--");
-        } else {
-            auto hh_mm_ss = Utils::extractTimeFromMs(
-                Config::Settings().time_length_ms - TimeInfo::elapsed);
-
-            QString h, m, s;
-            h = QString::number(std::get<0>(hh_mm_ss));
-            m = QString::number(std::get<1>(hh_mm_ss));
-            s = QString::number(std::get<2>(hh_mm_ss));
-
-            if (std::get<0>(hh_mm_ss) < 10) { h = '0' + h; }
-            if (std::get<1>(hh_mm_ss) < 10) { m = '0' + m; }
-            if (std::get<2>(hh_mm_ss) < 10) { s = '0' + s; }
-
-            SidebarWidgets::timer_out->setText(h + ":" + m + ":" + s);
-        }
+    TRACE_SPAN("GameView::updateInfo");
+
+    updateTimerOut();
+    updateMoveCountOut();
+    updateObjectiveOut();
+}
+
+// the current time is calculated from subtracting the time limit with the
+// time elapsed on the game clock.
+void
+GameView::updateTimerOut()
+{
+    if (m_sidebar.timer_out == nullptr) { return; }
+
+    QElapsedTimer timer;
+    if (m_perf.enabled) { timer.start(); }
+
+    QString text;
+
+    if (m_game_state == GameState::GAME_PAUSED) {
+        text = " PAUSED ";
+    } else if (has_solver_task()) {
+        text = "--:--:--";
+    } else {
+        const auto hh_mm_ss = Utils::extractTimeFromMs(std::max(
+            0LL, Config::Settings().time_length_ms - m_time.elapsed()));
+
+        text = QString("%1:%2:%3")
+                   .arg(std::get<0>(hh_mm_ss), 2, 10, QChar('0'))
+                   .arg(std::get<1>(hh_mm_ss), 2, 10, QChar('0'))
+                   .arg(std::get<2>(hh_mm_ss), 2, 10, QChar('0'));
     }
 
-    if (SidebarWidgets::move_count_out != nullptr) {
-        SidebarWidgets::move_count_out->setText(QString::number(m_move_count));
+    if (text != m_sidebar.shown_time) {
+        m_sidebar.timer_out->setText(text);
+        m_sidebar.shown_time = text;
     }
 
-    if (SidebarWidgets::info_msg_label != nullptr) {
-        SidebarWidgets::info_msg_label->setText("OBJECTIVES");
-        SidebarWidgets::info_msg_label->setAlignment(Qt::AlignCenter);
+    recordSidebarUpdate(timer);
+}
+
+void
+GameView::updateMoveCountOut()
+{
+    // the timeline moves along with the move count
+    updateTimelineOut();
+
+    if (m_sidebar.move_count_out == nullptr
+        || m_sidebar.shown_move_count == m_move_count) {
+        return;
     }
 
-    if (SidebarWidgets::info_msg_out != nullptr) {
-        SidebarWidgets::info_msg_out->setText(
-            "Move All Slice to Stack "
-            + Utils::numToChar(HanoiStacks::goal_stack->getLabel()));
-        SidebarWidgets::info_msg_out->setAlignment(Qt::AlignCenter);
+    QElapsedTimer timer;
+    if (m_perf.enabled) { timer.start(); }
+
+    m_sidebar.shown_move_count = m_move_count;
+    m_sidebar.move_count_out->setText(QString::number(m_move_count));
+
+    recordSidebarUpdate(timer);
+}
+
+void
+GameView::updateObjectiveOut()
+{
+    if (m_sidebar.info_msg_out == nullptr
+        || m_stacks.goal_stack == nullptr
+        || m_sidebar.shown_goal == m_stacks.goal_stack->getLabel()) {
+        return;
+    }
+
+    m_sidebar.shown_goal = m_stacks.goal_stack->getLabel();
+    m_sidebar.info_msg_out->setText(
+        "Move All Slice to Stack "
+        + Utils::numToChar(m_stacks.goal_stack->getLabel()));
+}
+
+// save the time of a sidebar update, for the perf overlay
+void
+GameView::recordSidebarUpdate(const QElapsedTimer &timer)
+{
+    if (m_perf.enabled && timer.isValid()) {
+        m_perf.update_info_ms = timer.nsecsElapsed() / 1e6F;
     }
 }
@@ -0,0 +1,143 @@
+//-- Description -------------------------------------------------------------/
+// methods that handle the timeline slider, seeking is done on a preview      /
+// board built from the closest snapshot, the game itself is left untouched.  /
+//----------------------------------------------------------------------------/
+
+#include "gameview.h"
+
+#include "../Config/config.h"
+
+#include <algorithm>
+
+void
+GameView::setTimelineWidget(QSlider *slider)
+{
+    m_timeline.slider = slider;
+    updateTimelineOut();
+}
+
+void
+GameView::seekTimeline(int move)
+{
+    if (move < 0) { return; }
+
+    {
+        std::lock_guard<std::mutex> guard(m_timeline.lock);
+
+        // back on the current move, show the live board again. a running
+        // solver is followed while the slider is at it's end
+        m_timeline.target = (size_t(move) == m_history.position())
+                                ? SIZE_MAX
+                                : std::min(size_t(move), m_history.size());
+    }
+
+    // the preview is built once per painted frame, however many times the
+    // slider has moved since the last one
+    update();
+}
+
+void
+GameView::commitTimeline()
+{
+    if (!m_timeline.isActive() || has_solver_task()
+        || (m_game_state != GameState::GAME_RUNNING
+            && m_game_state != GameState::GAME_PAUSED)) {
+        return;
+    }
+
+    const size_t target = m_timeline.target;
+
+    m_timeline.target = SIZE_MAX;
+
+    while (m_history.position() > target && revertMove()) {}
+
+    MoveHistory::Move move;
+    while (m_history.position() < target
+           && m_history.moveAt(m_history.position(), move)
+           && replayMove(move)) {}
+
+    updateMoveCountOut();
+
+    repaint();
+
+    checkWinState();
+}
+
+void
+GameView::recordSnapshot(bool is_new)
+{
+    // the history has changed, the preview may be out of date
+    m_timeline.shown = SIZE_MAX;
+
+    uint8_t *const snapshot
+        = m_timeline.snapshots.record(m_history.position(), is_new);
+    if (snapshot == nullptr) { return; }
+
+    for (size_t i = 0; i < Config::Settings::stack_amount; i++) {
+        getStack(i)->forEverySlice([&](HanoiSlice *&slice) {
+            snapshot[slice->getLabel()] = uint8_t(i);
+        });
+    }
+}
+
+void
+GameView::resetTimeline()
+{
+    std::lock_guard<std::mutex> guard(m_timeline.lock);
+
+    // every slice starts on the first stack
+    m_timeline.snapshots.reset(Config::Settings::slice_amount);
+
+    m_timeline.target = SIZE_MAX;
+    m_timeline.shown  = SIZE_MAX;
+}
+
+void
+GameView::buildPreview(size_t move)
+{
+    const size_t slices = Config::Settings::slice_amount;
+
+    const size_t   snapshot = m_timeline.snapshots.closest(move);
+    const uint8_t *stacks   = m_timeline.snapshots.at(snapshot);
+
+    for (size_t i = 0; i < Config::Settings::stack_amount; i++) {
+        m_timeline.preview[i].clearStack();
+    }
+
+    // the slices are pushed from the largest, so every push is legal
+    for (size_t label = 0; label < slices; label++) {
+        m_timeline.preview[stacks[label]].push(new HanoiSlice(label));
+    }
+
+    MoveHistory::Move made;
+    for (size_t i = snapshot * BoardSnapshots::INTERVAL; i < move; i++) {
+        if (!m_history.moveAt(i, made)
+            || HanoiStack::tryMove(&m_timeline.preview[made.first],
+                                   &m_timeline.preview[made.second])
+                   != HanoiStack::MoveStatus::OK) {
+            break;
+        }
+    }
+
+    m_timeline.shown = move;
+}
+
+void
+GameView::updateTimelineOut()
+{
+    if (m_timeline.slider == nullptr || m_timeline.slider->isSliderDown()) {
+        return;
+    }
+
+    size_t length, position;
+    {
+        std::lock_guard<std::mutex> guard(m_timeline.lock);
+        length   = m_history.size();
+        position = m_history.position();
+    }
+
+    const QSignalBlocker blocker(m_timeline.slider);
+
+    m_timeline.slider->setMaximum(int(length));
+    if (!m_timeline.isActive()) { m_timeline.slider->setValue(int(position)); }
+}
@@ -5,6 +5,7 @@
 #include "gamewindow.h"
 #include <QMessageBox>
 #include <QPushButton>
+#include <QSlider>
 
 GameWindow::GameWindow(QWidget *parent)
     : QWidget(parent)
@@ -12,16 +13,21 @@ GameWindow::GameWindow(QWidget *parent)
 {
     ui->setupUi(this);
 
-    m_game_view = GameView::getInstance();
+    // owned by the display frame once it's added to it's layout
+    m_game_view = new GameView(this);
 
-    GameView::setSidebarWidget(ui->TimerOut,
-                               ui->MoveCountOut,
-                               ui->InfoLabel,
-                               ui->InfoOut);
+    m_game_view->setSidebarWidget(ui->TimerOut,
+                                  ui->MoveCountOut,
+                                  ui->InfoLabel,
+                                  ui->InfoOut);
 
     ui->GameDisplayFrame->layout()->addWidget(m_game_view);
 
-    ui->InfoOut->setReadOnly(true);
+    // the timeline under the board, seeks while dragged
+    m_timeline = new QSlider(Qt::Horizontal, this);
+    m_timeline->setRange(0, 0);
+    ui->GameDisplayFrame->layout()->addWidget(m_timeline);
+    m_game_view->setTimelineWidget(m_timeline);
 
     //========================================================================
 
@@ -106,11 +112,20 @@ GameWindow::GameWindow(QWidget *parent)
     connect(ui->UndoBtn, &QPushButton::clicked, m_game_view, &GameView::undo);
     connect(ui->RedoBtn, &QPushButton::clicked, m_game_view, &GameView::redo);
 
+    connect(m_timeline,
+            &QSlider::valueChanged,
+            m_game_view,
+            &GameView::seekTimeline);
+
+    connect(m_timeline,
+            &QSlider::sliderReleased,
+            m_game_view,
+            &GameView::commitTimeline);
+
     //========================================================================
 }
 
 GameWindow::~GameWindow()
 {
-    GameView::destroyInstance();
     delete ui;
 }
@@ -7,6 +7,7 @@
 
 #include "../GameView/gameview.h"
 #include "ui_gamewindow.h"
+#include <QSlider>
 #include <QWidget>
 
 namespace Ui {
@@ -22,7 +23,9 @@ public:
     bool &isSettingsBtnPressed() { return m_settings_btn_pressed; };
 
 private:
-    static inline GameView *m_game_view = nullptr;
+    GameView *m_game_view = nullptr;
+
+    QSlider *m_timeline = nullptr;
 
     bool m_settings_btn_pressed = false;
 
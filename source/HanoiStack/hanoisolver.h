@@ -0,0 +1,60 @@
+//-- Description -------------------------------------------------------------/
+// The iterative Hanoi Tower solving algorithm, gives the pair of stacks the  /
+// n-th move is made between. The direction of a move is always the only     /
+// legal one between the pair.                                                /
+//----------------------------------------------------------------------------/
+
+#ifndef HANOISOLVER_H
+#define HANOISOLVER_H
+
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <utility>
+
+class HanoiSolver {
+public:
+    HanoiSolver(size_t slice_amount, size_t goal)
+        : m_slice_amount(slice_amount)
+        , m_dest(goal)
+        , m_aux((goal == 1) ? goal + 1 : 1)    // the stack after the first,
+                                               // or after the goal stack
+    {
+        assert(m_dest != m_aux);
+        assert(m_source != m_dest);
+        assert(m_source != m_aux);
+
+        // swap dest with aux if slice_amount is an even number
+        if (slice_amount % 2 == 0) { std::swap(m_dest, m_aux); }
+    }
+
+    // (2^slice_amount) -1
+    inline size_t getMoveCount() const
+    {
+        // the shift is undefined from the width of size_t, where the count
+        // is the largest size_t
+        return (m_slice_amount < std::numeric_limits<size_t>::digits)
+                   ? (size_t(1) << m_slice_amount) - 1
+                   : SIZE_MAX;
+    }
+
+    // get the pair of stacks the i-th (starting from 1) move is made between
+    inline std::pair<size_t, size_t> getMove(size_t i) const
+    {
+        switch (i % 3) {
+            case 0:
+                return { m_aux, m_dest };
+            case 1:
+                return { m_source, m_dest };
+            default:
+                return { m_source, m_aux };
+        }
+    }
+
+private:
+    size_t m_slice_amount = 0;
+    size_t m_source = 0, m_dest = 0, m_aux = 0;
+};
+
+#endif    // HANOISOLVER_H
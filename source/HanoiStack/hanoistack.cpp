@@ -4,6 +4,8 @@
 
 #include "hanoistack.h"
 
+#include "../Trace/trace.h"
+
 #include "hanoislice.h"
 #include <cassert>
 #include <functional>
@@ -19,6 +21,16 @@ HanoiStack::clearStack()
 
 void
 HanoiStack::push(HanoiSlice* slice)
+{
+    if (tryPush(slice) != MoveStatus::OK) {
+        throw std::runtime_error(
+            "HanoiStack::push(): tried to move a larger slice on top a smaller "
+            "slice.");
+    }
+}
+
+HanoiStack::MoveStatus
+HanoiStack::tryPush(HanoiSlice* slice)
 {
     assert(slice != nullptr);
 
@@ -26,9 +38,7 @@ HanoiStack::push(HanoiSlice* slice)
         m_head = slice;
         m_tail = m_head;
     } else if (slice->getLabel() < peek()->getLabel()) {
-        throw std::runtime_error(
-            "HanoiStack::push(): tried to move a larger slice on top a smaller "
-            "slice.");
+        return MoveStatus::ILLEGAL;
     } else {
         slice->Next()  = m_head;
         slice->Prev()  = nullptr;
@@ -39,6 +49,40 @@ HanoiStack::push(HanoiSlice* slice)
         assert(m_head->Next() != nullptr);
     }
     m_size++;
+
+    return MoveStatus::OK;
+}
+
+HanoiStack::MoveStatus
+HanoiStack::tryMove(HanoiStack* source, HanoiStack* dest)
+{
+    assert(source != nullptr);
+    assert(dest != nullptr);
+
+    if (source == dest) { return MoveStatus::SAME_STACK; }
+    if (source->isEmpty()) { return MoveStatus::EMPTY_SOURCE; }
+    if (!isLegalMove(*source, *dest)) { return MoveStatus::ILLEGAL; }
+
+    dest->tryPush(source->pop());
+
+    return MoveStatus::OK;
+}
+
+std::pair<size_t, size_t>
+HanoiStack::makeLegalMove(HanoiStack* a, HanoiStack* b)
+{
+    TRACE_SPAN("HanoiStack::makeLegalMove");
+
+    assert(a != nullptr);
+    assert(b != nullptr);
+    assert((!a->isEmpty()) || (!b->isEmpty()));
+
+    if (tryMove(a, b) == MoveStatus::OK) {
+        return std::make_pair(a->getLabel(), b->getLabel());
+    }
+
+    tryMove(b, a);
+    return std::make_pair(b->getLabel(), a->getLabel());
 }
 
 void
@@ -58,7 +102,11 @@ HanoiStack::pop()
 
     m_head = m_head->Next();
 
-    if (m_head != nullptr) { m_head->Prev() = nullptr; }
+    if (m_head != nullptr) {
+        m_head->Prev() = nullptr;
+    } else {
+        m_tail = nullptr;
+    }
 
     --m_size;
 
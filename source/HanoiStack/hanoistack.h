@@ -11,16 +11,47 @@
 
 #include <cstddef>
 #include <functional>
+#include <utility>
 
 class HanoiStack {
 public:
+    // result of the non-throwing operations
+    enum class MoveStatus {
+        OK,
+        EMPTY_SOURCE,    // nothing to move
+        SAME_STACK,      // source and destination are the same stack
+        ILLEGAL,         // larger slice on top of a smaller slice
+    };
+
     HanoiStack() {};
     HanoiStack(size_t label) : m_label(label) {};
     ~HanoiStack() { clearStack(); };
 
     void clearStack();
+
+    // throws std::runtime_error on an illegal push
     void push(HanoiSlice* slice);
 
+    // push without throwing, the slice is not taken if it's not OK
+    MoveStatus tryPush(HanoiSlice* slice);
+
+    // move the top slice of 'source' to 'dest', without throwing
+    static MoveStatus tryMove(HanoiStack* source, HanoiStack* dest);
+
+    // move the top slice between two stacks in the only legal direction,
+    // returns the (source, dest) labels of the move made
+    static std::pair<size_t, size_t> makeLegalMove(HanoiStack* a,
+                                                   HanoiStack* b);
+
+    // check if the top slice of 'source' can be moved on top of 'dest'
+    static inline bool isLegalMove(const HanoiStack& source,
+                                   const HanoiStack& dest)
+    {
+        return !source.isEmpty()
+               && (dest.isEmpty()
+                   || source.peek()->getLabel() > dest.peek()->getLabel());
+    }
+
     HanoiSlice*             pop();
     const HanoiSlice* const peek() const { return m_head; }
 
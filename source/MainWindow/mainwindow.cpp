@@ -5,10 +5,14 @@
 
 #include "mainwindow.h"
 
+#include "../BoardRenderer/boardrenderer.h"
 #include "../GameWindow/gamewindow.h"
 #include "../SettingsWindow/settingswindow.h"
+#include "../Startup/startup.h"
 #include "../Utils/utils.h"
 #include "ui_mainwindow.h"
+#include <QThreadPool>
+#include <QTimer>
 #include <qmessagebox.h>
 
 MainWindow::MainWindow(QWidget *parent)
@@ -19,23 +23,124 @@ MainWindow::MainWindow(QWidget *parent)
 
     this->setStyleSheet(Utils::getDefaultStylesheet());
 
-    m_settings_window = new SettingsWindow(this);
-    m_game_window     = new GameWindow(this);
-
-    ui->WidgetFrame->layout()->addWidget(m_settings_window);
-    ui->WidgetFrame->layout()->addWidget(m_game_window);
-
+    // only the menu is built here, the rest is done in stages after the
+    // first frame (see runStartupStage())
     ui->GameTitle->setPixmap(m_logo);
 
     ui->WidgetFrame->hide();
     ui->GameMenuFrame->show();
-    m_game_window->hide();
-    m_settings_window->hide();
+
+    // main window slots
+    connect(ui->StartExitBtn,
+            &QPushButton::clicked,
+            this,
+            &MainWindow::exitGame);
+
+    connect(ui->StartBtn,
+            &QPushButton::clicked,
+            this,
+            &MainWindow::openGameView);
+
+    connect(ui->SettingsBtn,
+            &QPushButton::clicked,
+            this,
+            &MainWindow::openSettingsMenu);
+
+    Startup::mark("menu");
+}
+
+MainWindow::~MainWindow()
+{
+#ifndef DISABLE_AUDIO
+    Config::m_bg_music = nullptr;
+#endif
+    delete m_game_window;
+    delete m_settings_window;
+    delete ui;
 
 #ifndef DISABLE_AUDIO
-    Config::m_bg_music_output = m_background_music.m_audio_output;
-    m_background_music.m_media_player->play();
+    // after the game window, it's solver plays through the mixer
+    Config::m_sfx_mixer = nullptr;
+    delete m_sfx_mixer;
 #endif
+}
+
+void
+MainWindow::paintEvent(QPaintEvent *event)
+{
+    QMainWindow::paintEvent(event);
+
+    if (m_startup_stage > 0) { return; }
+    m_startup_stage = 1;
+
+    // queued behind the flush of this frame
+    QTimer::singleShot(0, this, &MainWindow::runStartupStage);
+}
+
+// one stage per pass of the event loop, so the menu keeps handling input.
+// a button that needs a window before it's stage builds it right away
+void
+MainWindow::runStartupStage()
+{
+    switch (m_startup_stage++) {
+        case 1:
+            Startup::firstFrame();
+
+            // the sprites are decoded off the gui thread, the first
+            // renderer waits for them if they're not done yet
+            QThreadPool::globalInstance()->start(
+                []() { BoardRenderer::preloadSprites(); });
+            break;
+
+        case 2:
+            initAudio();
+            Startup::mark("audio");
+            break;
+
+        case 3:
+            gameWindow();
+            Startup::mark("game window");
+            break;
+
+        case 4:
+            settingsWindow();
+            Startup::mark("settings window");
+            break;
+
+        default: Startup::ready(); return;
+    }
+
+    QTimer::singleShot(0, this, &MainWindow::runStartupStage);
+}
+
+void
+MainWindow::initAudio()
+{
+#ifndef DISABLE_AUDIO
+    // decodes the sound effects once, for every window that plays them
+    m_sfx_mixer = new SfxMixer();
+    m_sfx_mixer->setVolume(Config::Settings::fx_volume);
+    m_sfx_mixer->start();
+
+    Config::m_sfx_mixer = m_sfx_mixer;
+
+    m_background_music = new MusicStream(Config::AudioFiles::BACKGROUND_MUSIC,
+                                         this);
+    m_background_music->setVolume(Config::Settings::music_volume);
+    m_background_music->start();
+
+    Config::m_bg_music = m_background_music;
+#endif
+}
+
+GameWindow *
+MainWindow::gameWindow()
+{
+    if (m_game_window != nullptr) { return m_game_window; }
+
+    m_game_window = new GameWindow(this);
+    ui->WidgetFrame->layout()->addWidget(m_game_window);
+    m_game_window->hide();
 
     // game window slots
     connect(m_game_window,
@@ -53,40 +158,31 @@ MainWindow::MainWindow(QWidget *parent)
             this,
             &MainWindow::exitGame);
 
+    return m_game_window;
+}
+
+SettingsWindow *
+MainWindow::settingsWindow()
+{
+    if (m_settings_window != nullptr) { return m_settings_window; }
+
+    m_settings_window = new SettingsWindow(this);
+    ui->WidgetFrame->layout()->addWidget(m_settings_window);
+    m_settings_window->hide();
+
     // setting window slots
     connect(m_settings_window,
             &SettingsWindow::s_hidden,
             this,
             &MainWindow::settingsWindowCloseEvent);
 
-    // main window slots
-    connect(ui->StartExitBtn,
-            &QPushButton::clicked,
-            this,
-            &MainWindow::exitGame);
-
-    connect(ui->StartBtn,
-            &QPushButton::clicked,
-            this,
-            &MainWindow::openGameView);
-
-    connect(ui->SettingsBtn,
-            &QPushButton::clicked,
-            this,
-            &MainWindow::openSettingsMenu);
-}
-
-MainWindow::~MainWindow()
-{
-    delete m_game_window;
-    delete m_settings_window;
-    delete ui;
+    return m_settings_window;
 }
 
 void
 MainWindow::settingsWindowCloseEvent()
 {
-    if (m_game_window->isSettingsBtnPressed()) {
+    if (m_game_window != nullptr && m_game_window->isSettingsBtnPressed()) {
         openGameView();
         m_game_window->isSettingsBtnPressed() = false;
     } else {
@@ -105,8 +201,8 @@ MainWindow::openMainMenu()
 {
     ui->GameMenuFrame->show();
     ui->WidgetFrame->hide();
-    m_settings_window->hide();
-    m_game_window->hide();
+    if (m_settings_window != nullptr) { m_settings_window->hide(); }
+    if (m_game_window != nullptr) { m_game_window->hide(); }
 }
 
 void
@@ -114,7 +210,7 @@ MainWindow::openGameView()
 {
     ui->GameMenuFrame->hide();
     ui->WidgetFrame->show();
-    m_game_window->show();
+    gameWindow()->show();
 }
 
 void
@@ -122,6 +218,6 @@ MainWindow::openSettingsMenu()
 {
     ui->GameMenuFrame->hide();
     ui->WidgetFrame->show();
-    m_game_window->hide();
-    m_settings_window->show();
+    if (m_game_window != nullptr) { m_game_window->hide(); }
+    settingsWindow()->show();
 }
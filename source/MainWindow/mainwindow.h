@@ -12,8 +12,8 @@
 #include <QMainWindow>
 
 #ifndef DISABLE_AUDIO
-    #include <QAudioOutput>
-    #include <QMediaPlayer>
+    #include "../Audio/musicstream.h"
+    #include "../Audio/sfxmixer.h"
 #endif    // !DISABLE_AUDIO
 
 namespace Ui {
@@ -34,44 +34,25 @@ private:
     const QPixmap m_logo = QPixmap(Config::AssetsFiles::LOGO);
 
 #ifndef DISABLE_AUDIO
-    struct BackgroundAudio_t {
-        QMediaPlayer *m_media_player = nullptr;
-        QAudioOutput *m_audio_output = nullptr;
-
-        // void setSource(const QString &path)
-        // {
-        // 	m_media_player->setSource("qrc" + path);
-        // }
-
-        BackgroundAudio_t()
-        {
-            m_media_player = new QMediaPlayer;
-            m_audio_output = new QAudioOutput;
-
-            // disable video output
-            m_media_player->setVideoOutput(nullptr);
-
-            // load the audio source
-            m_media_player->setAudioOutput(m_audio_output);
-            m_media_player->setSource(
-                QString(Config::AudioFiles::BACKGROUND_MUSIC));
+    MusicStream *m_background_music = nullptr;
+    SfxMixer    *m_sfx_mixer        = nullptr;
+#endif    // !DISABLE_AUDIO
 
-            // configure audio
-            m_audio_output->setVolume(Config::Settings::music_volume);
-            m_media_player->setLoops(QMediaPlayer::Infinite);
-        };
+    // 0 until the first paint, then the next stage to run
+    int m_startup_stage = 0;
 
-        ~BackgroundAudio_t()
-        {
-            delete m_audio_output;
-            delete m_media_player;
-        }
+    // build the window on first use
+    GameWindow     *gameWindow();
+    SettingsWindow *settingsWindow();
 
-    } m_background_music;
+    void initAudio();
 
-#endif
+protected:
+    // starts the staged initialisation once the first frame is painted
+    void paintEvent(QPaintEvent *event) override;
 
 private slots:
+    void runStartupStage();
     void settingsWindowCloseEvent();
     void exitGame();
     void openMainMenu();
@@ -0,0 +1,345 @@
+//-- Description -------------------------------------------------------------/
+// methods that build the OpenMetrics text, and export it. the file is        /
+// replaced with QSaveFile so a scraper never reads a partial one, and the    /
+// socket is served from the gui thread when a client connects.               /
+//----------------------------------------------------------------------------/
+
+#include "metrics.h"
+
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QSaveFile>
+#include <QSocketNotifier>
+#include <QTimer>
+#include <algorithm>
+#include <cstring>
+
+#ifdef Q_OS_UNIX
+    #include <cerrno>
+    #include <fcntl.h>
+    #include <sys/socket.h>
+    #include <sys/stat.h>
+    #include <sys/un.h>
+    #include <unistd.h>
+#endif    // Q_OS_UNIX
+
+namespace {
+    struct CounterInfo {
+        const char *family;
+        const char *labels;
+        const char *help;
+    };
+
+    // in the order of Metrics::Counter, the samples of a family are
+    // consecutive
+    constexpr CounterInfo COUNTERS[] = {
+        { "hanoi_moves", "", "Moves applied, by the player or the solver." },
+        { "hanoi_illegal_moves", "", "Moves attempted and rejected." },
+        { "hanoi_solver_moves", "", "Moves made by the solver." },
+        { "hanoi_paints", "", "Frames painted by the game view." },
+        { "hanoi_resets", "", "Games reset." },
+        { "hanoi_games", "{outcome=\"won\"}", "Games finished, by outcome." },
+        { "hanoi_games", "{outcome=\"lost\"}", "Games finished, by outcome." },
+        { "hanoi_audio_triggers", "", "Sound effects triggered." },
+    };
+
+    static_assert(sizeof(COUNTERS) / sizeof(COUNTERS[0])
+                      == size_t(Metrics::Counter::COUNT),
+                  "every counter needs a description");
+
+    // the timer and the socket, only touched from the gui thread
+    struct Exporter {
+        static inline Metrics::Options options;
+
+        static inline QTimer          *timer    = nullptr;
+        static inline QSocketNotifier *notifier = nullptr;
+        static inline int              fd       = -1;
+
+#ifdef Q_OS_UNIX
+        // the socket file this process has bound, only it is removed
+        static inline dev_t socket_dev = 0;
+        static inline ino_t socket_ino = 0;
+#endif    // Q_OS_UNIX
+
+        // the solver rate is sampled every interval
+        static inline QElapsedTimer rate_timer;
+        static inline uint64_t      rate_solver_moves  = 0;
+        static inline double        solver_moves_per_s = 0;
+    };
+
+    void
+    sampleRates()
+    {
+        const uint64_t solver_moves
+            = Metrics::counter(Metrics::Counter::SOLVER_MOVES);
+
+        if (Exporter::rate_timer.isValid()) {
+            const double seconds = Exporter::rate_timer.nsecsElapsed() / 1e9;
+            if (seconds > 0) {
+                Exporter::solver_moves_per_s
+                    = (solver_moves - Exporter::rate_solver_moves) / seconds;
+            }
+        }
+
+        Exporter::rate_solver_moves = solver_moves;
+        Exporter::rate_timer.start();
+    }
+}    // namespace
+
+void
+Metrics::observePaint(int64_t ns)
+{
+    const double ms = ns / 1e6;
+
+    size_t bucket = 0;
+    while (bucket < PAINT_BUCKET_COUNT && ms > PAINT_BUCKETS_MS[bucket]) {
+        bucket++;
+    }
+
+    paint_buckets[bucket].fetch_add(1, std::memory_order_relaxed);
+    paint_sum_ns.fetch_add(uint64_t(std::max<int64_t>(ns, 0)),
+                           std::memory_order_relaxed);
+}
+
+QByteArray
+Metrics::text()
+{
+    QByteArray out;
+    out.reserve(4096);
+
+    const char *family = nullptr;
+
+    for (size_t i = 0; i < size_t(Counter::COUNT); i++) {
+        const CounterInfo &info = COUNTERS[i];
+
+        if (family == nullptr || qstrcmp(family, info.family) != 0) {
+            family = info.family;
+            out += QByteArray("# TYPE ") + family + " counter\n";
+            out += QByteArray("# HELP ") + family + ' ' + info.help + '\n';
+        }
+
+        out += QByteArray(family) + "_total" + info.labels + ' '
+               + QByteArray::number(qulonglong(
+                   counters[i].load(std::memory_order_relaxed)))
+               + '\n';
+    }
+
+    out += "# TYPE hanoi_move_queue_depth gauge\n"
+           "# HELP hanoi_move_queue_depth Moves entered and not executed "
+           "yet.\n"
+           "hanoi_move_queue_depth "
+           + QByteArray::number(qlonglong(
+               gauges[size_t(Gauge::MOVE_QUEUE_DEPTH)].load(
+                   std::memory_order_relaxed)))
+           + '\n';
+
+    out += "# TYPE hanoi_solver_moves_per_second gauge\n"
+           "# HELP hanoi_solver_moves_per_second Solver moves per second, "
+           "over the last interval.\n"
+           "hanoi_solver_moves_per_second "
+           + QByteArray::number(Exporter::solver_moves_per_s, 'f', 2) + '\n';
+
+    // the buckets are kept apart, and made cumulative here
+    out += "# TYPE hanoi_paint_duration_seconds histogram\n"
+           "# HELP hanoi_paint_duration_seconds Time spent painting a "
+           "frame.\n";
+
+    uint64_t count = 0;
+    for (size_t i = 0; i <= PAINT_BUCKET_COUNT; i++) {
+        count += paint_buckets[i].load(std::memory_order_relaxed);
+
+        const QByteArray le
+            = (i < PAINT_BUCKET_COUNT)
+                  ? QByteArray::number(PAINT_BUCKETS_MS[i] / 1e3, 'g', 6)
+                  : QByteArray("+Inf");
+
+        out += "hanoi_paint_duration_seconds_bucket{le=\"" + le + "\"} "
+               + QByteArray::number(qulonglong(count)) + '\n';
+    }
+
+    out += "hanoi_paint_duration_seconds_sum "
+           + QByteArray::number(
+               paint_sum_ns.load(std::memory_order_relaxed) / 1e9, 'g', 9)
+           + '\n';
+    out += "hanoi_paint_duration_seconds_count "
+           + QByteArray::number(qulonglong(count)) + '\n';
+
+    out += "# EOF\n";
+
+    return out;
+}
+
+bool
+Metrics::start(const Options &options)
+{
+    if (options.file.isEmpty() && options.socket.isEmpty()) { return true; }
+
+    Exporter::options = options;
+
+    // nothing is enabled until every export is up, the paints are only
+    // timed once one is
+    if (!options.file.isEmpty() && !writeFile()) { return false; }
+    if (!options.socket.isEmpty() && !listen()) { return false; }
+
+    enabled = true;
+
+    sampleRates();
+
+    Exporter::timer = new QTimer(QCoreApplication::instance());
+    QObject::connect(Exporter::timer, &QTimer::timeout, []() {
+        sampleRates();
+        if (!Exporter::options.file.isEmpty()) { writeFile(); }
+    });
+    Exporter::timer->start(std::max(options.interval_ms, 100));
+
+    return true;
+}
+
+void
+Metrics::stop()
+{
+    if (!enabled) { return; }
+
+    delete Exporter::timer;
+    Exporter::timer = nullptr;
+
+    sampleRates();
+    if (!Exporter::options.file.isEmpty()) { writeFile(); }
+
+    delete Exporter::notifier;
+    Exporter::notifier = nullptr;
+
+#ifdef Q_OS_UNIX
+    if (Exporter::fd >= 0) {
+        ::close(Exporter::fd);
+        Exporter::fd = -1;
+
+        // the path may have been replaced since, by another run or a file
+        const QByteArray path = QFile::encodeName(Exporter::options.socket);
+
+        struct stat status {};
+        if (::lstat(path.constData(), &status) == 0
+            && S_ISSOCK(status.st_mode) && status.st_dev == Exporter::socket_dev
+            && status.st_ino == Exporter::socket_ino) {
+            ::unlink(path.constData());
+        }
+    }
+#endif    // Q_OS_UNIX
+
+    enabled = false;
+}
+
+bool
+Metrics::writeFile()
+{
+    const QByteArray out = text();
+
+    QSaveFile file(Exporter::options.file);
+    if (!file.open(QIODevice::WriteOnly) || file.write(out) != out.size()
+        || !file.commit()) {
+        qWarning("can't write the metrics to '%s'",
+                 qPrintable(Exporter::options.file));
+        return false;
+    }
+
+    return true;
+}
+
+// a client gets the current text as soon as it connects, then the
+// connection is closed, the way a local textfile endpoint is scraped
+bool
+Metrics::listen()
+{
+#ifdef Q_OS_UNIX
+    const QByteArray path = QFile::encodeName(Exporter::options.socket);
+
+    sockaddr_un address {};
+    address.sun_family = AF_UNIX;
+
+    if (size_t(path.size()) >= sizeof(address.sun_path)) {
+        qWarning("the metrics socket path '%s' is too long", path.constData());
+        return false;
+    }
+
+    std::memcpy(address.sun_path, path.constData(), size_t(path.size()));
+
+    // a socket left behind by a previous run is replaced, anything else at
+    // the path is kept
+    struct stat status {};
+    if (::lstat(path.constData(), &status) == 0) {
+        if (!S_ISSOCK(status.st_mode)) {
+            qWarning("'%s' exists and is not a socket", path.constData());
+            return false;
+        }
+
+        ::unlink(path.constData());
+    }
+
+    const int fd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd < 0) { return false; }
+
+    if (::bind(fd, reinterpret_cast<sockaddr *>(&address), sizeof(address))
+            != 0
+        || ::listen(fd, 8) != 0
+        || ::fcntl(fd, F_SETFL, ::fcntl(fd, F_GETFL) | O_NONBLOCK) != 0) {
+        qWarning("can't listen on the metrics socket '%s'", path.constData());
+        ::close(fd);
+        return false;
+    }
+
+    if (::lstat(path.constData(), &status) == 0) {
+        Exporter::socket_dev = status.st_dev;
+        Exporter::socket_ino = status.st_ino;
+    }
+
+    Exporter::fd       = fd;
+    Exporter::notifier = new QSocketNotifier(
+        qintptr(fd), QSocketNotifier::Read, QCoreApplication::instance());
+    QObject::connect(Exporter::notifier,
+                     &QSocketNotifier::activated,
+                     &Metrics::serveClients);
+
+    return true;
+#else
+    qWarning("the metrics socket needs a unix system");
+    return false;
+#endif    // Q_OS_UNIX
+}
+
+void
+Metrics::serveClients()
+{
+#ifdef Q_OS_UNIX
+#ifdef MSG_NOSIGNAL
+    constexpr int FLAGS = MSG_NOSIGNAL;    // a client that left early
+#else
+    constexpr int FLAGS = 0;
+#endif
+
+    for (;;) {
+        const int client = ::accept(Exporter::fd, nullptr, nullptr);
+        if (client < 0) { break; }
+
+#ifdef SO_NOSIGPIPE
+        const int no_sigpipe = 1;
+        ::setsockopt(
+            client, SOL_SOCKET, SO_NOSIGPIPE, &no_sigpipe, sizeof(no_sigpipe));
+#endif
+
+        const QByteArray out = text();
+
+        for (qsizetype sent = 0; sent < out.size();) {
+            const ssize_t n = ::send(client,
+                                     out.constData() + sent,
+                                     size_t(out.size() - sent),
+                                     FLAGS);
+            if (n < 0 && errno == EINTR) { continue; }
+            if (n <= 0) { break; }
+            sent += n;
+        }
+
+        ::close(client);
+    }
+#endif    // Q_OS_UNIX
+}
@@ -0,0 +1,94 @@
+//-- Description -------------------------------------------------------------/
+// Counters and histograms of the game, exposed in the OpenMetrics text       /
+// format. They are written to a file every few seconds, and/or served on a   /
+// local unix socket to every client that connects. Updating a metric is a    /
+// single relaxed atomic add, the text is only built when it's exported.      /
+//----------------------------------------------------------------------------/
+
+#ifndef METRICS_H
+#define METRICS_H
+
+#include <QByteArray>
+#include <QString>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+class Metrics {
+public:
+    enum class Counter {
+        MOVES,              // applied, by the player or the solver
+        ILLEGAL_MOVES,      // attempted and rejected
+        SOLVER_MOVES,
+        PAINTS,
+        RESETS,
+        GAMES_WON,
+        GAMES_LOST,
+        AUDIO_TRIGGERS,
+        COUNT,
+    };
+
+    enum class Gauge {
+        MOVE_QUEUE_DEPTH,
+        COUNT,
+    };
+
+    // upper bounds of the paint duration buckets, in ms
+    static constexpr double PAINT_BUCKETS_MS[]
+        = { 1, 2, 4, 8, 16, 33, 50, 100 };
+    static constexpr size_t PAINT_BUCKET_COUNT
+        = sizeof(PAINT_BUCKETS_MS) / sizeof(PAINT_BUCKETS_MS[0]);
+
+    struct Options {
+        QString file;                  // written every interval, or empty
+        QString socket;                // unix socket path, or empty
+        int     interval_ms = 10000;
+    };
+
+    // can be called from any thread
+    static void add(Counter counter, uint64_t amount = 1)
+    {
+        counters[size_t(counter)].fetch_add(amount, std::memory_order_relaxed);
+    }
+
+    static void set(Gauge gauge, int64_t value)
+    {
+        gauges[size_t(gauge)].store(value, std::memory_order_relaxed);
+    }
+
+    static void observePaint(int64_t ns);
+
+    static uint64_t counter(Counter counter)
+    {
+        return counters[size_t(counter)].load(std::memory_order_relaxed);
+    }
+
+    // a metric is exported, the paints are only timed while one is
+    static bool isEnabled() { return enabled; }
+
+    // start exporting, must be called from the gui thread
+    static bool start(const Options &options);
+
+    // write the file a last time, and remove the socket
+    static void stop();
+
+    // every metric in the OpenMetrics text format
+    static QByteArray text();
+
+private:
+    static inline bool enabled = false;
+
+    static inline std::atomic<uint64_t> counters[size_t(Counter::COUNT)] = {};
+    static inline std::atomic<int64_t>  gauges[size_t(Gauge::COUNT)]     = {};
+
+    // the last bucket is +Inf
+    static inline std::atomic<uint64_t> paint_buckets[PAINT_BUCKET_COUNT + 1]
+        = {};
+    static inline std::atomic<uint64_t> paint_sum_ns = 0;
+
+    static bool writeFile();
+    static bool listen();
+    static void serveClients();
+};
+
+#endif    // METRICS_H
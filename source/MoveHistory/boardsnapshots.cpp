@@ -0,0 +1,35 @@
+//-- Description -------------------------------------------------------------/
+// methods of the board snapshots, a snapshot is only ever appended or        /
+// truncated at the end, in the order of the history.                         /
+//----------------------------------------------------------------------------/
+
+#include "boardsnapshots.h"
+
+void
+BoardSnapshots::reset(size_t slice_amount)
+{
+    m_slice_amount = slice_amount;
+    m_stacks.assign(slice_amount, 0);
+}
+
+uint8_t *
+BoardSnapshots::record(size_t position, bool is_new)
+{
+    assert(position > 0);
+
+    // the board before the new move is shared with the discarded line, the
+    // snapshots after it belong to that line only
+    if (is_new) {
+        const size_t kept = (position - 1) / INTERVAL + 1;
+        if (count() > kept) { m_stacks.resize(kept * m_slice_amount); }
+    }
+
+    // not on the interval, or redone over an existing snapshot
+    if (position % INTERVAL != 0 || count() > position / INTERVAL) {
+        return nullptr;
+    }
+
+    m_stacks.resize(m_stacks.size() + m_slice_amount);
+
+    return m_stacks.data() + m_stacks.size() - m_slice_amount;
+}
@@ -0,0 +1,54 @@
+//-- Description -------------------------------------------------------------/
+// Snapshots of the board every INTERVAL moves of the history, the timeline   /
+// seeks from the closest one and replays the moves after it. A snapshot      /
+// holds the stack label of every slice. A new move that discards the undone  /
+// moves also discards the snapshots taken on them.                           /
+//----------------------------------------------------------------------------/
+
+#ifndef BOARDSNAPSHOTS_H
+#define BOARDSNAPSHOTS_H
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+class BoardSnapshots {
+public:
+    static constexpr size_t INTERVAL = 64;    // moves
+
+    // forget every snapshot, and take the one of the starting board (all
+    // slices on stack 0)
+    void reset(size_t slice_amount);
+
+    // called after every move recorded, the history is at 'position' and
+    // 'is_new' is false if the move was a redo. gives the snapshot to fill
+    // if one is due at 'position', nullptr otherwise
+    uint8_t *record(size_t position, bool is_new);
+
+    // amount of snapshots, the i-th is the board after i * INTERVAL moves
+    size_t count() const
+    {
+        return (m_slice_amount > 0) ? m_stacks.size() / m_slice_amount : 0;
+    }
+
+    // the last snapshot at or before 'move'
+    size_t closest(size_t move) const
+    {
+        assert(count() > 0);
+        return std::min(move / INTERVAL, count() - 1);
+    }
+
+    const uint8_t *at(size_t i) const
+    {
+        assert(i < count());
+        return m_stacks.data() + i * m_slice_amount;
+    }
+
+private:
+    std::vector<uint8_t> m_stacks;
+    size_t               m_slice_amount = 0;
+};
+
+#endif    // BOARDSNAPSHOTS_H
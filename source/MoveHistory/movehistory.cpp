@@ -0,0 +1,198 @@
+//-- Description -------------------------------------------------------------/
+// methods of the move history, the spill file holds the moves [0, m_base)   /
+// when spilling is enabled, so a segment is always appended or truncated at  /
+// the end of it.                                                             /
+//----------------------------------------------------------------------------/
+
+#include "movehistory.h"
+
+#include <QTemporaryFile>
+#include <algorithm>
+
+static_assert(Config::STACK_MAX <= 16, "a stack label must fit in 4 bits");
+
+MoveHistory::MoveHistory(size_t memory_limit)
+    : m_limit(std::max(memory_limit, SEGMENT))
+{
+}
+
+MoveHistory::~MoveHistory() { delete m_spill_file; }
+
+void
+MoveHistory::setSpill(bool enabled)
+{
+    m_spill_enabled = enabled;
+}
+
+bool
+MoveHistory::record(size_t source, size_t dest)
+{
+    const uint8_t move = encode(source, dest);
+
+    // making the undone move again is a redo, otherwise the undone moves
+    // are discarded
+    if (canRedo() && m_moves[m_cursor - m_base] == move) {
+        ++m_cursor;
+        return false;
+    }
+
+    m_moves.resize(m_cursor - m_base);
+
+    m_moves.push_back(move);
+    ++m_cursor;
+
+    if (m_moves.size() > m_limit) { spillSegment(); }
+
+    return true;
+}
+
+MoveHistory::Move
+MoveHistory::undoMove()
+{
+    assert(canUndo());
+
+    if (m_cursor == m_base && !readBackSegment()) { return Move(0, 0); }
+
+    return decode(m_moves[m_cursor - m_base - 1]);
+}
+
+MoveHistory::Move
+MoveHistory::redoMove() const
+{
+    assert(canRedo());
+
+    return decode(m_moves[m_cursor - m_base]);
+}
+
+void
+MoveHistory::stepBack()
+{
+    assert(m_cursor > m_base);
+    --m_cursor;
+}
+
+void
+MoveHistory::stepForward()
+{
+    assert(canRedo());
+    ++m_cursor;
+}
+
+void
+MoveHistory::clear()
+{
+    m_moves.clear();
+    m_base = m_cursor = m_spilled = 0;
+
+    delete m_spill_file;
+    m_spill_file = nullptr;
+}
+
+bool
+MoveHistory::moveAt(size_t i, Move &move) const
+{
+    if (i >= size()) { return false; }
+
+    if (i >= m_base) {
+        move = decode(m_moves[i - m_base]);
+        return true;
+    }
+
+    // spilled, or dropped if it's not in the spill file
+    char packed = 0;
+    if (i >= m_spilled || m_base != m_spilled || m_spill_file == nullptr
+        || !m_spill_file->seek(qint64(i)) || !m_spill_file->getChar(&packed)) {
+        return false;
+    }
+
+    move = decode(uint8_t(packed));
+    return true;
+}
+
+bool
+MoveHistory::moves(std::vector<Move> &out) const
+{
+    // the moves before the spill file are gone
+    if (m_spilled != m_base) { return false; }
+
+    out.clear();
+    out.reserve(m_cursor);
+
+    if (m_spilled > 0) {
+        std::vector<uint8_t> spilled(m_spilled);
+
+        if (m_spill_file == nullptr || !m_spill_file->seek(0)
+            || m_spill_file->read(reinterpret_cast<char *>(spilled.data()),
+                                  qint64(m_spilled))
+                   != qint64(m_spilled)) {
+            return false;
+        }
+
+        for (const uint8_t move : spilled) { out.push_back(decode(move)); }
+    }
+
+    for (size_t i = 0; i < m_cursor - m_base; i++) {
+        out.push_back(decode(m_moves[i]));
+    }
+
+    return true;
+}
+
+void
+MoveHistory::spillSegment()
+{
+    const size_t amount = std::min(SEGMENT, m_cursor - m_base);
+
+    if (m_spill_enabled) {
+        if (m_spill_file == nullptr) {
+            m_spill_file = new QTemporaryFile();
+            if (!m_spill_file->open()) {
+                qWarning("MoveHistory: can't open a spill file");
+                delete m_spill_file;
+                m_spill_file = nullptr;
+            }
+        }
+
+        if (m_spill_file != nullptr
+            && m_spill_file->seek(qint64(m_spilled))
+            && m_spill_file->write(reinterpret_cast<const char *>(
+                   m_moves.data()),
+                   qint64(amount))
+                   == qint64(amount)) {
+            m_spilled += amount;
+        } else {
+            // the spilled moves can't be undone anymore
+            qWarning("MoveHistory: failed to spill, dropping old moves");
+            m_spilled = 0;
+        }
+    }
+
+    m_moves.erase(m_moves.begin(), m_moves.begin() + amount);
+    m_base += amount;
+}
+
+bool
+MoveHistory::readBackSegment()
+{
+    if (m_spilled == 0 || m_spill_file == nullptr) { return false; }
+
+    const size_t amount = std::min(SEGMENT, m_spilled);
+    const size_t offset = m_spilled - amount;
+
+    std::vector<uint8_t> segment(amount);
+
+    if (!m_spill_file->seek(qint64(offset))
+        || m_spill_file->read(reinterpret_cast<char *>(segment.data()),
+                              qint64(amount))
+               != qint64(amount)) {
+        qWarning("MoveHistory: failed to read back spilled moves");
+        m_spilled = 0;
+        return false;
+    }
+
+    m_moves.insert(m_moves.begin(), segment.begin(), segment.end());
+    m_spilled -= amount;
+    m_base -= amount;
+
+    return true;
+}
@@ -0,0 +1,106 @@
+//-- Description -------------------------------------------------------------/
+// Contiguous history of the moves made in a game, every move is stored as a  /
+// single byte. Undo/redo only move a cursor over the buffer. The buffer is   /
+// bounded, the oldest segments are spilled to a temporary file (or dropped)  /
+// and are read back when undo reaches them.                                  /
+//----------------------------------------------------------------------------/
+
+#ifndef MOVEHISTORY_H
+#define MOVEHISTORY_H
+
+#include "../Config/config.h"
+
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+class QTemporaryFile;
+
+class MoveHistory {
+public:
+    // the (source, dest) stack labels of a move
+    using Move = std::pair<size_t, size_t>;
+
+    // amount of moves spilled/read back at once
+    static constexpr size_t SEGMENT = size_t(1) << 16;
+
+    // 'memory_limit' is the amount of moves kept in memory
+    explicit MoveHistory(size_t memory_limit = Config::HISTORY_MEMORY_MAX);
+    ~MoveHistory();
+
+    MoveHistory(const MoveHistory &)            = delete;
+    MoveHistory &operator=(const MoveHistory &) = delete;
+
+    // spill the moves over the memory limit to a temporary file, instead
+    // of dropping them
+    void setSpill(bool enabled);
+
+    // save a move after the cursor, the undone moves are discarded unless
+    // it is the next one of them. returns false if it was, a redo
+    bool record(size_t source, size_t dest);
+
+    bool canUndo() const { return m_cursor > m_base || m_spilled > 0; }
+    bool canRedo() const { return m_cursor < m_base + m_moves.size(); }
+
+    // the move the next undo reverts, reads back a spilled segment if
+    // needed. gives (0, 0) if the segment can't be read back
+    Move undoMove();
+
+    // the move the next redo makes
+    Move redoMove() const;
+
+    // step the cursor back/forward over a move
+    void stepBack();
+    void stepForward();
+
+    // drop every move, and the spill file
+    void clear();
+
+    // every move up to the cursor, the spilled ones included. returns false
+    // if old moves were dropped, and the history is not complete
+    bool moves(std::vector<Move> &out) const;
+
+    // amount of moves made, the undone ones not included
+    size_t position() const { return m_cursor; }
+
+    // amount of moves made, the undone ones included
+    size_t size() const { return m_base + m_moves.size(); }
+
+    // the i-th move, returns false if it was dropped
+    bool moveAt(size_t i, Move &move) const;
+
+    // bytes held in memory
+    size_t memoryUsage() const { return m_moves.capacity(); }
+
+    // a move is packed as (source << 4) | dest
+    static inline uint8_t encode(size_t source, size_t dest)
+    {
+        assert(source < 16 && dest < 16);
+        return uint8_t((source << 4) | dest);
+    }
+
+    static inline Move decode(uint8_t move)
+    {
+        return Move(move >> 4, move & 0x0F);
+    }
+
+private:
+    // move the oldest segment out of memory
+    void spillSegment();
+
+    // bring the newest spilled segment back into memory
+    bool readBackSegment();
+
+    std::vector<uint8_t> m_moves;          // moves from m_base onwards
+    size_t               m_base    = 0;    // index of m_moves[0]
+    size_t               m_cursor  = 0;    // index of the next move
+    size_t               m_spilled = 0;    // moves in the spill file
+    size_t               m_limit;
+
+    bool            m_spill_enabled = false;
+    QTemporaryFile *m_spill_file    = nullptr;
+};
+
+#endif    // MOVEHISTORY_H
@@ -0,0 +1,262 @@
+//-- Description -------------------------------------------------------------/
+// methods of the branching undo tree                                         /
+//----------------------------------------------------------------------------/
+
+#include "movetree.h"
+
+#include <algorithm>
+#include <array>
+#include <cassert>
+
+MoveTree::MoveTree(size_t capacity)
+    : m_capacity(std::max<size_t>(capacity, 2))
+{
+    reset(0);
+}
+
+uint64_t
+MoveTree::sliceHash(size_t slice, size_t stack)
+{
+    assert(slice < Config::SLICE_MAX && stack < Config::STACK_MAX);
+
+    // zobrist keys from a fixed splitmix64 sequence, the same on every run
+    static const auto KEYS = []() {
+        std::array<uint64_t, Config::SLICE_MAX * Config::STACK_MAX> keys {};
+
+        uint64_t state = 0x9E3779B97F4A7C15ULL;
+        for (uint64_t &key : keys) {
+            uint64_t z = (state += 0x9E3779B97F4A7C15ULL);
+            z          = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+            z          = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+            key        = z ^ (z >> 31);
+        }
+
+        return keys;
+    }();
+
+    return KEYS[slice * Config::STACK_MAX + stack];
+}
+
+void
+MoveTree::reset(size_t slice_amount)
+{
+    m_nodes.clear();
+    m_free = NONE;
+
+    m_root = m_current = allocate();
+
+    for (size_t i = 0; i < slice_amount; i++) {
+        node(m_root).hash ^= sliceHash(i, 0);
+    }
+}
+
+void
+MoveTree::record(size_t source, size_t dest, size_t slice)
+{
+    assert(source < 16 && dest < 16);
+
+    const uint8_t packed = uint8_t((source << 4) | dest);
+
+    // the move was made from here before, follow the same branch
+    for (NodeId child = node(m_current).first_child; child != NONE;
+         child        = node(child).next_sibling) {
+        if (node(child).packed_move == packed) {
+            node(m_current).redo = child;
+            m_current            = child;
+            return;
+        }
+    }
+
+    // allocate() may prune the tree, m_current is only read after it
+    const NodeId child = allocate();
+
+    // the slice leaves 'source' and lands on 'dest'
+    const uint64_t hash = node(m_current).hash ^ sliceHash(slice, source)
+                          ^ sliceHash(slice, dest);
+
+    Node &n        = node(child);
+    n.parent       = m_current;
+    n.depth        = node(m_current).depth + 1;
+    n.packed_move  = packed;
+    n.hash         = hash;
+    n.next_sibling = node(m_current).first_child;
+
+    node(m_current).first_child = child;
+    node(m_current).redo        = child;
+
+    m_current = child;
+}
+
+void
+MoveTree::stepBack()
+{
+    assert(canUndo());
+
+    const NodeId child = m_current;
+
+    m_current            = node(child).parent;
+    node(m_current).redo = child;
+}
+
+void
+MoveTree::stepForward()
+{
+    assert(canRedo());
+    m_current = node(m_current).redo;
+}
+
+MoveTree::NodeId
+MoveTree::siblingBranch(bool next) const
+{
+    // walk up to the closest fork, remembering which child we came from
+    NodeId from = node(m_current).redo;
+    NodeId fork = m_current;
+
+    while (fork != NONE) {
+        std::vector<NodeId> children;
+        for (NodeId child = node(fork).first_child; child != NONE;
+             child        = node(child).next_sibling) {
+            children.push_back(child);
+        }
+
+        if (children.size() > 1) {
+            // children are linked newest first, keep the order stable
+            std::reverse(children.begin(), children.end());
+
+            const auto   it = std::find(children.begin(), children.end(), from);
+            const size_t i  = (it != children.end()) ? it - children.begin() : 0;
+            const size_t n  = children.size();
+
+            NodeId leaf = children[next ? (i + 1) % n : (i + n - 1) % n];
+
+            // the position last played on that branch
+            while (node(leaf).redo != NONE) { leaf = node(leaf).redo; }
+
+            return leaf;
+        }
+
+        from = fork;
+        fork = (fork == m_root) ? NONE : node(fork).parent;
+    }
+
+    return NONE;
+}
+
+void
+MoveTree::pathTo(NodeId             target,
+                 size_t            &undo_count,
+                 std::vector<Move> &redo) const
+{
+    assert(target < m_nodes.size() && node(target).in_use);
+
+    undo_count = 0;
+    redo.clear();
+
+    NodeId a = m_current, b = target;
+
+    while (node(a).depth > node(b).depth) {
+        a = node(a).parent;
+        ++undo_count;
+    }
+
+    while (node(b).depth > node(a).depth) {
+        redo.push_back(node(b).move());
+        b = node(b).parent;
+    }
+
+    while (a != b) {
+        a = node(a).parent;
+        ++undo_count;
+        redo.push_back(node(b).move());
+        b = node(b).parent;
+    }
+
+    std::reverse(redo.begin(), redo.end());
+}
+
+MoveTree::NodeId
+MoveTree::allocate()
+{
+    if (m_free == NONE && m_nodes.size() >= m_capacity) { prune(); }
+
+    NodeId id;
+
+    if (m_free != NONE) {
+        id     = m_free;
+        m_free = node(id).next_sibling;
+    } else {
+        assert(m_nodes.size() < m_capacity);
+        id = NodeId(m_nodes.size());
+        m_nodes.emplace_back();
+    }
+
+    node(id)        = Node();
+    node(id).in_use = true;
+
+    return id;
+}
+
+void
+MoveTree::release(NodeId id)
+{
+    node(id).in_use       = false;
+    node(id).next_sibling = m_free;
+    m_free                = id;
+}
+
+void
+MoveTree::prune()
+{
+    std::vector<bool> keep(m_nodes.size(), false);
+
+    // the path from the root
+    for (NodeId id = m_current; id != NONE; id = node(id).parent) {
+        keep[id] = true;
+        if (id == m_root) { break; }
+    }
+
+    // everything below the current node
+    std::vector<NodeId> pending { m_current };
+    while (!pending.empty()) {
+        const NodeId id = pending.back();
+        pending.pop_back();
+        keep[id] = true;
+
+        for (NodeId child = node(id).first_child; child != NONE;
+             child        = node(child).next_sibling) {
+            pending.push_back(child);
+        }
+    }
+
+    // only the path is left above the current node
+    for (NodeId id = m_current; id != m_root;) {
+        const NodeId parent      = node(id).parent;
+        node(parent).first_child = id;
+        node(parent).redo        = id;
+        node(id).next_sibling    = NONE;
+        id                       = parent;
+    }
+
+    bool freed = false;
+    for (NodeId id = 0; id < m_nodes.size(); id++) {
+        if (node(id).in_use && !keep[id]) {
+            release(id);
+            freed = true;
+        }
+    }
+
+    if (freed) { return; }
+
+    // the kept nodes fill the arena, start over from the current board
+    const Node current = node(m_current);
+
+    m_nodes.clear();
+    m_free = NONE;
+
+    m_nodes.emplace_back();
+    m_root = m_current = 0;
+
+    node(m_root).hash   = current.hash;
+    node(m_root).depth  = current.depth;
+    node(m_root).in_use = true;
+}
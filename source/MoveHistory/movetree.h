@@ -0,0 +1,98 @@
+//-- Description -------------------------------------------------------------/
+// Branching undo tree of the moves a player made. A move made after an undo  /
+// starts a new branch next to the old one, instead of discarding it, and     /
+// branches share their common prefix. Nodes live in a pooled arena and are   /
+// addressed by index. Every node keeps a hash of the board it leads to.      /
+//----------------------------------------------------------------------------/
+
+#ifndef MOVETREE_H
+#define MOVETREE_H
+
+#include "../Config/config.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+class MoveTree {
+public:
+    // the (source, dest) stack labels of a move
+    using Move   = std::pair<size_t, size_t>;
+    using NodeId = uint32_t;
+
+    static constexpr NodeId NONE = UINT32_MAX;
+
+    // 'capacity' is the amount of nodes the arena may hold
+    explicit MoveTree(size_t capacity = Config::MOVE_TREE_MAX);
+
+    // drop every node, the root is the starting board of 'slice_amount'
+    // slices (all on stack 0)
+    void reset(size_t slice_amount);
+
+    // make a move of 'slice' from the current node, the child is reused if
+    // the move was made from here before
+    void record(size_t source, size_t dest, size_t slice);
+
+    bool canUndo() const { return m_current != m_root; }
+    bool canRedo() const { return node(m_current).redo != NONE; }
+
+    // the move the next undo reverts / the next redo makes
+    Move undoMove() const { return node(m_current).move(); }
+    Move redoMove() const { return node(node(m_current).redo).move(); }
+
+    // step to the parent / to the branch the next redo follows
+    void stepBack();
+    void stepForward();
+
+    // the leaf of the next/previous branch, at the fork closest to the
+    // current node. NONE if there is no other branch
+    NodeId siblingBranch(bool next) const;
+
+    // the moves to undo, then to make, to get from the current node to
+    // 'target', found through their common ancestor in O(depth)
+    void pathTo(NodeId target, size_t &undo_count, std::vector<Move> &redo)
+        const;
+
+    // hash of the board at the current node
+    uint64_t hash() const { return node(m_current).hash; }
+
+    // hash of 'slice' being on 'stack', a board hash is the xor of all of
+    // it's slices
+    static uint64_t sliceHash(size_t slice, size_t stack);
+
+private:
+    struct Node {
+        uint64_t hash         = 0;
+        NodeId   parent       = NONE;
+        NodeId   first_child  = NONE;
+        NodeId   next_sibling = NONE;    // also links the free list
+        NodeId   redo         = NONE;    // the child the last visit went to
+        uint32_t depth        = 0;
+        uint8_t  packed_move  = 0;       // (source << 4) | dest
+        bool     in_use       = false;
+
+        Move move() const { return Move(packed_move >> 4, packed_move & 0x0F); }
+    };
+
+    const Node &node(NodeId id) const { return m_nodes[id]; }
+    Node       &node(NodeId id) { return m_nodes[id]; }
+
+    // take a node from the free list or the end of the arena, prunes the
+    // tree when the arena is full
+    NodeId allocate();
+
+    // free every node that is not on the path to the current node, nor below
+    // it. if that frees nothing, the current node becomes the only one.
+    void prune();
+
+    void release(NodeId id);
+
+    std::vector<Node> m_nodes;
+    NodeId            m_free    = NONE;
+    NodeId            m_root    = NONE;
+    NodeId            m_current = NONE;
+    size_t            m_capacity;
+};
+
+#endif    // MOVETREE_H
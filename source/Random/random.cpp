@@ -0,0 +1,85 @@
+//-- Description -------------------------------------------------------------/
+// methods that map the generator to ranges, and hand out the game seeds of   /
+// the session. the entropy device is only read once, if no seed is set.      /
+//----------------------------------------------------------------------------/
+
+#include "random.h"
+
+#include <mutex>
+#include <random>
+
+namespace {
+    // the generator of the game seeds
+    struct Session {
+        static inline std::mutex lock;
+        static inline uint64_t   seed    = 0;
+        static inline bool       started = false;
+        static inline Random     rng { 0 };
+    };
+
+    // seed the session from the entropy device if it isn't yet, the lock
+    // must be held
+    Random &
+    sessionLocked()
+    {
+        if (Session::started) { return Session::rng; }
+
+        while (Session::seed == 0) {
+            std::random_device device;
+            Session::seed = (uint64_t(device()) << 32) | device();
+        }
+
+        Session::rng     = Random(Session::seed);
+        Session::started = true;
+
+        return Session::rng;
+    }
+}    // namespace
+
+size_t
+Random::range(size_t min, size_t max)
+{
+    const uint64_t span = uint64_t(max - min) + 1;
+
+    // the whole range of the generator
+    if (span == 0) { return size_t(next()); }
+
+    // drop the values below 2^64 % span, the rest is a multiple of span
+    const uint64_t threshold = (0 - span) % span;
+
+    uint64_t value = next();
+    while (value < threshold) { value = next(); }
+
+    return min + size_t(value % span);
+}
+
+void
+Random::setSessionSeed(uint64_t seed)
+{
+    std::lock_guard<std::mutex> guard(Session::lock);
+
+    Session::seed    = seed;
+    Session::started = false;
+}
+
+uint64_t
+Random::sessionSeed()
+{
+    std::lock_guard<std::mutex> guard(Session::lock);
+
+    sessionLocked();
+    return Session::seed;
+}
+
+uint64_t
+Random::nextGameSeed()
+{
+    std::lock_guard<std::mutex> guard(Session::lock);
+
+    Random &rng = sessionLocked();
+
+    uint64_t seed = rng.next();
+    while (seed == 0) { seed = rng.next(); }
+
+    return seed;
+}
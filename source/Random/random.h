@@ -0,0 +1,44 @@
+//-- Description -------------------------------------------------------------/
+// Seeded random numbers. The session has a single seed (see '--seed'), every /
+// game draws it's own seed from it, and the random choices of a game (the    /
+// goal stack...) are generated from the game's seed. The generator is        /
+// splitmix64 and ranges are mapped without the standard distributions, which /
+// differ between standard libraries, so a seed gives the same game anywhere. /
+//----------------------------------------------------------------------------/
+
+#ifndef RANDOM_H
+#define RANDOM_H
+
+#include <cstddef>
+#include <cstdint>
+
+class Random {
+public:
+    explicit Random(uint64_t seed = 0) : m_state(seed) {}
+
+    uint64_t next()
+    {
+        uint64_t z = (m_state += 0x9E3779B97F4A7C15ULL);
+        z          = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+        z          = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+        return z ^ (z >> 31);
+    }
+
+    // uniform in [min, max], without modulo bias
+    size_t range(size_t min, size_t max);
+
+    // restart the session from 'seed', 0 picks one from the entropy device
+    static void setSessionSeed(uint64_t seed);
+
+    // the seed the session was started with, never 0
+    static uint64_t sessionSeed();
+
+    // the seed of the next game of the session, never 0 (0 is an unknown
+    // seed in a replay)
+    static uint64_t nextGameSeed();
+
+private:
+    uint64_t m_state;
+};
+
+#endif    // RANDOM_H
@@ -0,0 +1,387 @@
+//-- Description -------------------------------------------------------------/
+// methods that write and read the replay files. a move only stores the pair  /
+// of stacks it is made between, the direction is the only legal one and is   /
+// recovered by replaying it on the board.                                    /
+//----------------------------------------------------------------------------/
+
+#include "replay.h"
+
+#include "../Config/config.h"
+
+#include <QSaveFile>
+#include <QtEndian>
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+
+// header layout:
+//   0  "HNRP"               4  u16 version           6  u8 stack_amount
+//   7  u8 slice_amount      8  u8 goal               9  u8 result
+//   10 u8 bits_per_move     11 u8 reserved           12 u32 interval
+//   16 u64 seed             24 i64 started_at_ms     32 i64 duration_ms
+//   40 i64 time_limit_ms    48 u64 move_count
+static constexpr qint64 HEADER_SIZE      = 56;
+static constexpr qint64 FOOTER_SIZE      = 24;
+static constexpr qint64 INDEX_ENTRY_SIZE = 16;
+static constexpr char   HEADER_MAGIC[]   = "HNRP";
+static constexpr char   FOOTER_MAGIC[]   = "HNRI";
+
+template<typename T>
+static void
+appendLE(QByteArray &out, T value)
+{
+    char bytes[sizeof(T)];
+    qToLittleEndian(value, bytes);
+    out.append(bytes, sizeof(T));
+}
+
+template<typename T>
+static T
+readLE(const uchar *data)
+{
+    return qFromLittleEndian<T>(data);
+}
+
+uint8_t
+Replay::bitsPerMove(size_t stack_amount)
+{
+    const size_t pairs = stack_amount * (stack_amount - 1) / 2;
+
+    uint8_t bits = 1;
+    while ((size_t(1) << bits) < pairs) { ++bits; }
+
+    return bits;
+}
+
+size_t
+Replay::pairIndex(size_t a, size_t b, size_t stack_amount)
+{
+    assert(a < b && b < stack_amount);
+
+    size_t index = 0;
+    for (size_t i = 0; i < a; i++) { index += stack_amount - 1 - i; }
+
+    return index + (b - a - 1);
+}
+
+Replay::Move
+Replay::pairFromIndex(size_t index, size_t stack_amount)
+{
+    for (size_t a = 0; a + 1 < stack_amount; a++) {
+        const size_t pairs = stack_amount - 1 - a;
+        if (index < pairs) { return Move(a, a + 1 + index); }
+        index -= pairs;
+    }
+
+    return Move(0, 0);    // not a valid pair
+}
+
+bool
+Replay::applyMove(const Move           &pair,
+                  std::vector<uint8_t> &slice_stacks,
+                  Move                 *made)
+{
+    // the top slice of a stack is the one with the highest label on it
+    long long top_a = -1, top_b = -1;
+    for (size_t label = 0; label < slice_stacks.size(); label++) {
+        if (slice_stacks[label] == pair.first) { top_a = label; }
+        if (slice_stacks[label] == pair.second) { top_b = label; }
+    }
+
+    if (pair.first == pair.second || (top_a < 0 && top_b < 0)) {
+        return false;
+    }
+
+    const bool      from_a = top_a > top_b;
+    const Move      move   = from_a ? pair : Move(pair.second, pair.first);
+    const long long top    = from_a ? top_a : top_b;
+
+    slice_stacks[top] = uint8_t(move.second);
+
+    if (made != nullptr) { *made = move; }
+
+    return true;
+}
+
+bool
+Replay::save(const QString           &path,
+             const Info              &info,
+             const std::vector<Move> &moves)
+{
+    if (info.stack_amount < 3 || info.stack_amount > Config::STACK_MAX
+        || info.slice_amount < 1 || info.slice_amount > Config::SLICE_MAX
+        || info.goal >= info.stack_amount) {
+        qWarning("Replay::save(): invalid game configuration");
+        return false;
+    }
+
+    const uint8_t bits = bitsPerMove(info.stack_amount);
+
+    QByteArray out;
+
+    // header
+    out.append(HEADER_MAGIC, 4);
+    appendLE<uint16_t>(out, VERSION);
+    appendLE<uint8_t>(out, uint8_t(info.stack_amount));
+    appendLE<uint8_t>(out, uint8_t(info.slice_amount));
+    appendLE<uint8_t>(out, uint8_t(info.goal));
+    appendLE<uint8_t>(out, info.result);
+    appendLE<uint8_t>(out, bits);
+    appendLE<uint8_t>(out, 0);
+    appendLE<uint32_t>(out, CHECKPOINT_INTERVAL);
+    appendLE<uint64_t>(out, info.seed);
+    appendLE<int64_t>(out, info.started_at_ms);
+    appendLE<int64_t>(out, info.duration_ms);
+    appendLE<int64_t>(out, info.time_limit_ms);
+    appendLE<uint64_t>(out, moves.size());
+
+    assert(out.size() == HEADER_SIZE);
+
+    // the moves, with a padding byte so a move can always be read as 16 bits
+    const qint64 moves_size = (qint64(moves.size()) * bits + 7) / 8 + 1;
+    out.append(QByteArray(moves_size, 0));
+
+    uchar *const packed
+        = reinterpret_cast<uchar *>(out.data()) + HEADER_SIZE;
+
+    // replay the game, to validate it and to take the checkpoints
+    std::vector<uint8_t> state(info.slice_amount, 0);
+
+    QByteArray                             checkpoints;
+    std::vector<std::pair<size_t, qint64>> index;
+
+    const qint64 checkpoints_offset = out.size();
+
+    for (size_t i = 0; i < moves.size(); i++) {
+        if (i % CHECKPOINT_INTERVAL == 0) {
+            index.emplace_back(i, checkpoints_offset + checkpoints.size());
+            checkpoints.append(reinterpret_cast<const char *>(state.data()),
+                               state.size());
+        }
+
+        const Move &move = moves[i];
+        Move        made;
+
+        if (move.first >= info.stack_amount
+            || move.second >= info.stack_amount
+            || !applyMove(move, state, &made) || made != move) {
+            qWarning("Replay::save(): move %zu is not legal", i);
+            return false;
+        }
+
+        const size_t pair = pairIndex(std::min(move.first, move.second),
+                                      std::max(move.first, move.second),
+                                      info.stack_amount);
+
+        const size_t   bit  = i * bits;
+        const uint32_t word = uint32_t(pair) << (bit % 8);
+
+        packed[bit / 8] |= uchar(word & 0xFF);
+        packed[bit / 8 + 1] |= uchar(word >> 8);
+    }
+
+    // a game without moves still gets the starting checkpoint
+    if (index.empty()) {
+        index.emplace_back(0, checkpoints_offset);
+        checkpoints.append(reinterpret_cast<const char *>(state.data()),
+                           state.size());
+    }
+
+    out.append(checkpoints);
+
+    // index & footer
+    const qint64 index_offset = out.size();
+
+    for (const auto &entry : index) {
+        appendLE<uint64_t>(out, entry.first);
+        appendLE<uint64_t>(out, entry.second);
+    }
+
+    appendLE<uint64_t>(out, index_offset);
+    appendLE<uint64_t>(out, index.size());
+    out.append(FOOTER_MAGIC, 4);
+    appendLE<uint32_t>(out, 0);
+
+    // written to a temporary file first, so a failed save keeps the old one
+    QSaveFile file(path);
+    if (!file.open(QIODevice::WriteOnly) || file.write(out) != out.size()
+        || !file.commit()) {
+        qWarning("Replay::save(): can't write '%s'", qPrintable(path));
+        return false;
+    }
+
+    return true;
+}
+
+bool
+Replay::open(const QString &path)
+{
+    close();
+
+    m_file.setFileName(path);
+    if (!m_file.open(QIODevice::ReadOnly)) { return false; }
+
+    m_size = m_file.size();
+    if (m_size < HEADER_SIZE + FOOTER_SIZE) {
+        close();
+        return false;
+    }
+
+    m_data = m_file.map(0, m_size);
+    if (m_data == nullptr) {
+        close();
+        return false;
+    }
+
+    const uchar *const footer = m_data + m_size - FOOTER_SIZE;
+
+    if (std::memcmp(m_data, HEADER_MAGIC, 4) != 0
+        || std::memcmp(footer + 16, FOOTER_MAGIC, 4) != 0
+        || readLE<uint16_t>(m_data + 4) != VERSION
+        || readLE<uint32_t>(m_data + 12) != CHECKPOINT_INTERVAL) {
+        close();
+        return false;
+    }
+
+    m_info.stack_amount  = m_data[6];
+    m_info.slice_amount  = m_data[7];
+    m_info.goal          = m_data[8];
+    m_info.result        = m_data[9];
+    m_bits_per_move      = m_data[10];
+    m_info.seed          = readLE<uint64_t>(m_data + 16);
+    m_info.started_at_ms = readLE<int64_t>(m_data + 24);
+    m_info.duration_ms   = readLE<int64_t>(m_data + 32);
+    m_info.time_limit_ms = readLE<int64_t>(m_data + 40);
+
+    const uint64_t move_count   = readLE<uint64_t>(m_data + 48);
+    const uint64_t index_offset = readLE<uint64_t>(footer);
+    const uint64_t index_count  = readLE<uint64_t>(footer + 8);
+
+    if (m_info.stack_amount < 3 || m_info.stack_amount > Config::STACK_MAX
+        || m_info.slice_amount < 1 || m_info.slice_amount > Config::SLICE_MAX
+        || m_info.goal >= m_info.stack_amount
+        || m_bits_per_move != bitsPerMove(m_info.stack_amount)) {
+        close();
+        return false;
+    }
+
+    // the counts and the offset are bounded by the file size before any
+    // arithmetic is done on them, so none of it can overflow
+    if (move_count > uint64_t(m_size) * 8 / m_bits_per_move
+        || index_count == 0
+        || index_count > uint64_t(m_size) / INDEX_ENTRY_SIZE
+        || index_offset > uint64_t(m_size)) {
+        close();
+        return false;
+    }
+
+    m_move_count   = size_t(move_count);
+    m_index_count  = size_t(index_count);
+    m_index_offset = qint64(index_offset);
+
+    const qint64 moves_size
+        = (qint64(m_move_count) * m_bits_per_move + 7) / 8 + 1;
+
+    if (HEADER_SIZE + moves_size > m_index_offset
+        || m_index_offset + qint64(m_index_count) * INDEX_ENTRY_SIZE
+               != m_size - FOOTER_SIZE) {
+        close();
+        return false;
+    }
+
+    m_checkpoints_offset = HEADER_SIZE + moves_size;
+
+    return true;
+}
+
+void
+Replay::close()
+{
+    if (m_data != nullptr) { m_file.unmap(const_cast<uchar *>(m_data)); }
+    if (m_file.isOpen()) { m_file.close(); }
+
+    m_data               = nullptr;
+    m_size               = 0;
+    m_move_count         = 0;
+    m_checkpoints_offset = 0;
+    m_index_offset       = 0;
+    m_index_count        = 0;
+}
+
+Replay::Move
+Replay::movePair(size_t i) const
+{
+    assert(i < m_move_count);
+
+    const size_t       bit  = i * m_bits_per_move;
+    const uchar *const byte = m_data + HEADER_SIZE + bit / 8;
+    const uint32_t     word = byte[0] | (uint32_t(byte[1]) << 8);
+
+    return pairFromIndex((word >> (bit % 8)) & ((1U << m_bits_per_move) - 1),
+                         m_info.stack_amount);
+}
+
+bool
+Replay::stateAt(size_t n, std::vector<uint8_t> &slice_stacks) const
+{
+    if (!isOpen() || n > m_move_count) { return false; }
+
+    const auto entry = [&](size_t k) {
+        return m_data + m_index_offset + qint64(k) * INDEX_ENTRY_SIZE;
+    };
+
+    // find the last checkpoint at or before move 'n'
+    size_t low = 0, high = m_index_count;
+    while (high - low > 1) {
+        const size_t mid = (low + high) / 2;
+        if (readLE<uint64_t>(entry(mid)) <= n) {
+            low = mid;
+        } else {
+            high = mid;
+        }
+    }
+
+    const uint64_t checkpoint_move   = readLE<uint64_t>(entry(low));
+    const uint64_t checkpoint_offset = readLE<uint64_t>(entry(low) + 8);
+
+    // the checkpoint must lie between the moves and the index
+    if (checkpoint_move > n
+        || checkpoint_offset < uint64_t(m_checkpoints_offset)
+        || checkpoint_offset > uint64_t(m_index_offset)
+        || uint64_t(m_index_offset) - checkpoint_offset
+               < m_info.slice_amount) {
+        return false;
+    }
+
+    slice_stacks.assign(m_data + checkpoint_offset,
+                        m_data + checkpoint_offset + m_info.slice_amount);
+
+    for (const uint8_t stack : slice_stacks) {
+        if (stack >= m_info.stack_amount) { return false; }
+    }
+
+    for (size_t i = checkpoint_move; i < n; i++) {
+        if (!applyMove(movePair(i), slice_stacks)) { return false; }
+    }
+
+    return true;
+}
+
+bool
+Replay::moves(std::vector<Move> &out) const
+{
+    out.clear();
+    if (!isOpen()) { return false; }
+
+    out.reserve(m_move_count);
+
+    std::vector<uint8_t> state(m_info.slice_amount, 0);
+
+    for (size_t i = 0; i < m_move_count; i++) {
+        Move made;
+        if (!applyMove(movePair(i), state, &made)) { return false; }
+        out.push_back(made);
+    }
+
+    return true;
+}
@@ -0,0 +1,104 @@
+//-- Description -------------------------------------------------------------/
+// Binary replay file of a whole game. The moves are bit-packed, with a full  /
+// board checkpoint every CHECKPOINT_INTERVAL moves, and an index of the      /
+// checkpoints at the end of the file. The reader maps the file, so the      /
+// board at any move is found with a binary search over the index and at     /
+// most CHECKPOINT_INTERVAL moves replayed.                                   /
+//                                                                            /
+// layout (little-endian):                                                    /
+//   header       HEADER_SIZE bytes, see replay.cpp                           /
+//   moves        move_count * bits_per_move bits, plus one padding byte      /
+//   checkpoints  slice_amount bytes each, the stack label of every slice     /
+//   index        (u64 move, u64 file offset) of every checkpoint             /
+//   footer       u64 index offset, u64 index count, "HNRI", u32 reserved     /
+//----------------------------------------------------------------------------/
+
+#ifndef REPLAY_H
+#define REPLAY_H
+
+#include <QFile>
+#include <QString>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+class Replay {
+public:
+    // the (source, dest) stack labels of a move
+    using Move = std::pair<size_t, size_t>;
+
+    static constexpr uint16_t VERSION             = 1;
+    static constexpr uint32_t CHECKPOINT_INTERVAL = 4096;    // moves
+
+    struct Info {
+        size_t   stack_amount  = 3;
+        size_t   slice_amount  = 5;
+        size_t   goal          = 2;    // label of the goal stack
+        uint8_t  result        = 0;    // GameView::GameState at save time
+        uint64_t seed          = 0;    // session seed, 0 if unknown
+        int64_t  started_at_ms = 0;    // ms since the unix epoch
+        int64_t  duration_ms   = 0;    // game clock at save time
+        int64_t  time_limit_ms = 0;
+    };
+
+    Replay() = default;
+    ~Replay() { close(); }
+
+    Replay(const Replay &)            = delete;
+    Replay &operator=(const Replay &) = delete;
+
+    // write a game to 'path', every move must be legal from the starting
+    // board (all slices on stack 0)
+    static bool save(const QString           &path,
+                     const Info              &info,
+                     const std::vector<Move> &moves);
+
+    // map a replay file, returns false if it is not a valid replay
+    bool open(const QString &path);
+
+    void close();
+
+    bool isOpen() const { return m_data != nullptr; }
+
+    const Info &info() const { return m_info; }
+
+    size_t moveCount() const { return m_move_count; }
+
+    // the stack label of every slice after the first 'n' moves
+    bool stateAt(size_t n, std::vector<uint8_t> &slice_stacks) const;
+
+    // every move of the game, with it's direction. returns false if a move
+    // is not legal, the file is corrupt
+    bool moves(std::vector<Move> &out) const;
+
+    // amount of bits a move is packed into, for 'stack_amount' stacks
+    static uint8_t bitsPerMove(size_t stack_amount);
+
+private:
+    // the unordered pair of stacks the i-th move is made between
+    Move movePair(size_t i) const;
+
+    // make the only legal move between the pair, returns false if there is
+    // none
+    static bool applyMove(const Move           &pair,
+                          std::vector<uint8_t> &slice_stacks,
+                          Move                 *made = nullptr);
+
+    // index of the (a < b) pair among all pairs of 'stack_amount' stacks
+    static size_t pairIndex(size_t a, size_t b, size_t stack_amount);
+    static Move   pairFromIndex(size_t index, size_t stack_amount);
+
+    QFile        m_file;
+    const uchar *m_data = nullptr;
+    qint64       m_size = 0;
+
+    Info    m_info;
+    size_t  m_move_count         = 0;
+    uint8_t m_bits_per_move      = 0;
+    qint64  m_checkpoints_offset = 0;    // the end of the moves
+    qint64  m_index_offset       = 0;
+    size_t  m_index_count        = 0;
+};
+
+#endif    // REPLAY_H
@@ -9,7 +9,8 @@
 #include "ui_settingswindow.h"
 
 #ifndef DISABLE_AUDIO
-    #include <QSoundEffect>
+    #include "../Audio/musicstream.h"
+    #include "../Audio/sfxmixer.h"
 #endif    // !DISABLE_AUDIOLN
 
 #include <QSizeF>
@@ -23,11 +24,7 @@ SettingsWindow::SettingsWindow(QWidget* parent)
     // copy the global variables
     loadDefaults();
 
-#ifndef DISABLE_AUDIO
-    m_sfx_preview = new QSoundEffect(this);
-    m_sfx_preview->setSource(QString(Config::AudioFiles::PLACEMENT_FX));
-    assert(m_sfx_preview->status() != QSoundEffect::Error);
-#else
+#ifdef DISABLE_AUDIO
     // hide all audio setting options
     ui->AudioSFXVolOut->hide();
     ui->AudioMusicVolOut->hide();
@@ -44,7 +41,10 @@ SettingsWindow::SettingsWindow(QWidget* parent)
 
     // init the preview scene
     m_preview_scene = new QGraphicsScene;
+    m_preview_scene->setBackgroundBrush(QBrush(QColor("#59637c")));
     ui->PreviewOut->setScene(m_preview_scene);
+    ui->PreviewOut->setAlignment(Qt::AlignCenter);
+    createPreviewItems();
 
     // load the values
     updateDisplays();
@@ -55,9 +55,6 @@ SettingsWindow::SettingsWindow(QWidget* parent)
 
 SettingsWindow::~SettingsWindow()
 {
-#ifndef DISABLE_AUDIO
-    delete m_sfx_preview;
-#endif    // !DISABLE_AUDIO
     delete m_preview_scene;
     delete ui;
 }
@@ -175,7 +172,12 @@ void
 SettingsWindow::on_CancelButton_clicked()
 {
 #ifndef DISABLE_AUDIO
-    Config::m_bg_music_output->setVolume(Config::Settings::music_volume);
+    if (Config::m_bg_music != nullptr) {
+        Config::m_bg_music->setVolume(Config::Settings::music_volume);
+    }
+    if (Config::m_sfx_mixer != nullptr) {
+        Config::m_sfx_mixer->setVolume(Config::Settings::fx_volume);
+    }
 #endif
     hide();
 }
@@ -212,24 +214,46 @@ SettingsWindow::on_SaveButton_clicked()
     if (Settings.music_volume_level != Config::Settings::music_volume) {
         Config::Settings::music_volume = Settings.music_volume_level;
     }
+
+    if (Config::m_sfx_mixer != nullptr) {
+        Config::m_sfx_mixer->setVolume(Config::Settings::fx_volume);
+    }
 #endif
     hide();
 }
 
+void
+SettingsWindow::createPreviewItems()
+{
+    static const QPen pen(QBrush("#000000"), 4);
+
+    for (size_t i = 0; i < Config::STACK_MAX; i++) {
+        m_preview_items.poles[i] = m_preview_scene->addRect(QRectF(), pen);
+        m_preview_items.bases[i] = m_preview_scene->addRect(QRectF(), pen);
+    }
+
+    for (size_t i = 0; i < Config::SLICE_MAX; i++) {
+        m_preview_items.slices[i] = m_preview_scene->addRect(QRectF(), pen);
+    }
+}
+
+// lay out the persistent preview items, the items only repaint when their
+// rect or brush has actually changed
 void
 SettingsWindow::drawPreview()
 {
-    ui->PreviewOut->scene()->clear();
-    ui->PreviewOut->scene()->setBackgroundBrush(QBrush(QColor("#59637c")));
-    ui->PreviewOut->setSceneRect(0,
-                                 0,
-                                 ui->PreviewOut->viewport()->width(),
-                                 ui->PreviewOut->viewport()->height());
-    ui->PreviewOut->setAlignment(Qt::AlignCenter);
-    ui->PreviewOut->centerOn(m_preview_scene->sceneRect().center());
+    const QRectF scene_rect(0,
+                            0,
+                            ui->PreviewOut->viewport()->width(),
+                            ui->PreviewOut->viewport()->height());
+
+    if (m_preview_scene->sceneRect() != scene_rect) {
+        ui->PreviewOut->setSceneRect(scene_rect);
+        ui->PreviewOut->centerOn(scene_rect.center());
+    }
+
     // ----------------------------------------------------------------------
 
-    static const QPen    pen(QBrush("#000000"), 4);
     static constexpr int hpadding = 5;    // spacing
 
     const float sceneW = ui->PreviewOut->width();
@@ -249,21 +273,28 @@ SettingsWindow::drawPreview()
 
     {
         float x = 0;
-        for (size_t i = 0; i < Settings.stack_amount; i++) {
-            ui->PreviewOut->scene()->addRect(x + (stack_area.width() * 0.5F)
-                                                 - (stack_pole.width() * 0.5f),
-                                             sceneH - stack_pole.height(),
-                                             stack_pole.width(),
-                                             stack_pole.height(),
-                                             pen,
-                                             Settings.stack_color);
-
-            ui->PreviewOut->scene()->addRect(x,
-                                             sceneH - stack_base.height(),
-                                             stack_base.width(),
-                                             stack_base.height(),
-                                             pen,
-                                             Settings.stack_color);
+        for (size_t i = 0; i < Config::STACK_MAX; i++) {
+            QGraphicsRectItem *const pole = m_preview_items.poles[i];
+            QGraphicsRectItem *const base = m_preview_items.bases[i];
+
+            const bool visible = i < Settings.stack_amount;
+            pole->setVisible(visible);
+            base->setVisible(visible);
+
+            if (!visible) { continue; }
+
+            pole->setRect(x + (stack_area.width() * 0.5F)
+                              - (stack_pole.width() * 0.5f),
+                          sceneH - stack_pole.height(),
+                          stack_pole.width(),
+                          stack_pole.height());
+            pole->setBrush(Settings.stack_color);
+
+            base->setRect(x,
+                          sceneH - stack_base.height(),
+                          stack_base.width(),
+                          stack_base.height());
+            base->setBrush(Settings.stack_color);
 
             x += stack_area.width() + hpadding;    // shifting to right
         }
@@ -277,15 +308,19 @@ SettingsWindow::drawPreview()
 
         float y = (sceneH - stack_base.height());    // bottom y
 
-        for (size_t i = 0; i < Settings.slice_amount; i++) {
+        for (size_t i = 0; i < Config::SLICE_MAX; i++) {
+            QGraphicsRectItem *const item = m_preview_items.slices[i];
+
+            item->setVisible(i < Settings.slice_amount);
+            if (i >= Settings.slice_amount) { continue; }
+
             y -= slice.height();    // shift up
 
-            ui->PreviewOut->scene()->addRect(x - slice.width() * 0.5F,
-                                             y,
-                                             slice.width(),
-                                             slice.height(),
-                                             pen,
-                                             Settings.slice_color);
+            item->setRect(x - slice.width() * 0.5F,
+                          y,
+                          slice.width(),
+                          slice.height());
+            item->setBrush(Settings.slice_color);
             // scale down
             slice.setHeight(slice.height()
                             * Config::H_SCALE_FACTOR);    // scale down
@@ -295,28 +330,31 @@ SettingsWindow::drawPreview()
     }
 
     // ----------------------------------------------------------------------
-
-    ui->PreviewOut->resetTransform();
-    ui->PreviewOut->viewport()->update();
 }
 
 void
 SettingsWindow::on_GameSliceAmountSlider_valueChanged(int value)
 {
-    if (value > 0 && value <= Config::SLICE_MAX) {
-        Settings.slice_amount = value;
+    if (value <= 0 || value > Config::SLICE_MAX
+        || size_t(value) == Settings.slice_amount) {
+        return;
     }
-    updateDisplays();
+
+    Settings.slice_amount = value;
+    ui->GameSliceAmountOut->setText(QString::number(Settings.slice_amount));
     drawPreview();
 }
 
 void
 SettingsWindow::on_GameStackAmountSlider_valueChanged(int value)
 {
-    if (value > 0 && value <= Config::STACK_MAX) {
-        Settings.stack_amount = value;
+    if (value <= 0 || value > Config::STACK_MAX
+        || size_t(value) == Settings.stack_amount) {
+        return;
     }
-    updateDisplays();
+
+    Settings.stack_amount = value;
+    ui->GameStackAmountOut->setText(QString::number(Settings.stack_amount));
     drawPreview();
 }
 
@@ -326,8 +364,8 @@ SettingsWindow::on_AudioMusicVolSlider_sliderMoved(int position)
 #ifndef DISABLE_AUDIO
     Settings.music_volume_level = (position * 0.01f);
     updateDisplays();
-    if (Config::m_bg_music_output != nullptr) {
-        Config::m_bg_music_output->setVolume(Settings.music_volume_level);
+    if (Config::m_bg_music != nullptr) {
+        Config::m_bg_music->setVolume(Settings.music_volume_level);
     }
 #endif
 }
@@ -338,9 +376,10 @@ SettingsWindow::on_AudioSFXVolSlider_sliderMoved(int position)
 #ifndef DISABLE_AUDIO
     Settings.sfx_volume_level = (position * 0.01f);
     updateDisplays();
-    if (this->isVisible()) {
-        m_sfx_preview->setVolume(Settings.sfx_volume_level);
-        if (!m_sfx_preview->isPlaying()) { m_sfx_preview->play(); }
+    if (this->isVisible() && Config::m_sfx_mixer != nullptr) {
+        // the mixer merges the plays while the slider is dragged
+        Config::m_sfx_mixer->setVolume(Settings.sfx_volume_level);
+        Config::m_sfx_mixer->play(SfxMixer::Effect::PLACEMENT);
     }
 #endif
 }
@@ -5,14 +5,13 @@
 #ifndef SETTINGSWINDOW_H
 #define SETTINGSWINDOW_H
 
+#include "../Config/config.h"
+
 #include <QEvent>
+#include <QGraphicsRectItem>
 #include <QGraphicsScene>
 #include <QWidget>
 
-#ifndef DISABLE_AUDIO
-    #include <QSoundEffect>
-#endif    // !DISABLE_AUDIO
-
 namespace Ui {
     class SettingsWindow;
 }
@@ -34,6 +33,15 @@ private:
 
     QGraphicsScene *m_preview_scene = nullptr;
 
+    // the preview's rects are created once, and are only moved/re-colored
+    // when the settings or the view size change
+    struct PreviewItems {
+        QGraphicsRectItem *poles[Config::STACK_MAX]  = {};
+        QGraphicsRectItem *bases[Config::STACK_MAX]  = {};
+        QGraphicsRectItem *slices[Config::SLICE_MAX] = {};
+    } m_preview_items;
+
+    void createPreviewItems();
     void drawPreview();
     void updateDisplays();
 
@@ -55,11 +63,11 @@ private:
 
     void loadDefaults();
 
-    void resizeEvent(QResizeEvent *event) override { drawPreview(); }
-
-#ifndef DISABLE_AUDIO
-    QSoundEffect *m_sfx_preview = nullptr;
-#endif    // !DISABLE_AUDIO
+    void resizeEvent(QResizeEvent *event) override
+    {
+        drawPreview();
+        QWidget::resizeEvent(event);
+    }
 
 private slots:
     void on_ThemeSliceColorSettingsInput_editingFinished();
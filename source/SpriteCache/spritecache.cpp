@@ -0,0 +1,284 @@
+//-- Description -------------------------------------------------------------/
+// methods that read and write the sprite cache. an entry is a fixed header   /
+// followed by the pixels, written with QSaveFile so a reader never sees a    /
+// partial entry.                                                             /
+//----------------------------------------------------------------------------/
+
+#include "spritecache.h"
+
+#include "../Config/config.h"
+#include "../Trace/trace.h"
+
+#include <QDir>
+#include <QFile>
+#include <QSaveFile>
+#include <QStandardPaths>
+#include <QThread>
+#include <QThreadPool>
+#include <cstring>
+#include <mutex>
+#include <unordered_map>
+
+namespace {
+    constexpr char MAGIC[4] = { 'H', 'S', 'P', 'C' };
+
+    // native byte order, the cache never leaves the machine
+    struct Header {
+        char     magic[4];
+        uint32_t version;
+        uint64_t asset_hash;
+        uint32_t tint;
+        int32_t  width;
+        int32_t  height;
+        int32_t  bytes_per_line;
+        double   pixel_ratio;
+    };
+
+    // sprites waiting to be written, by slot
+    struct Pending {
+        struct Entry {
+            SpriteCache::Key key;
+            QImage           image;
+        };
+
+        static inline std::mutex                              lock;
+        static inline std::unordered_map<const void *, Entry> entries;
+        static inline uint64_t                                generation = 0;
+        static inline bool                                    flushing = false;
+    };
+
+    // sprites held by at least one renderer, by key hash
+    struct Shared {
+        struct Entry {
+            SpriteCache::Key key;
+            QImage           image;
+        };
+
+        static inline std::mutex                           lock;
+        static inline std::unordered_map<uint64_t, Entry> entries;
+    };
+
+    uint64_t
+    fnv1a(const void *data, size_t size, uint64_t hash = 0xCBF29CE484222325ULL)
+    {
+        const uchar *bytes = static_cast<const uchar *>(data);
+        for (size_t i = 0; i < size; i++) {
+            hash = (hash ^ bytes[i]) * 0x100000001B3ULL;
+        }
+        return hash;
+    }
+
+    bool
+    sameKey(const SpriteCache::Key &a, const SpriteCache::Key &b)
+    {
+        return a.asset_hash == b.asset_hash && a.tint == b.tint
+               && a.size == b.size && a.pixel_ratio == b.pixel_ratio;
+    }
+
+    uint64_t
+    keyHash(const SpriteCache::Key &key)
+    {
+        uint64_t hash = fnv1a(&key.asset_hash, sizeof(key.asset_hash));
+        hash          = fnv1a(&key.tint, sizeof(key.tint), hash);
+
+        const int size[2] = { key.size.width(), key.size.height() };
+        hash              = fnv1a(size, sizeof(size), hash);
+        return fnv1a(&key.pixel_ratio, sizeof(key.pixel_ratio), hash);
+    }
+}    // namespace
+
+uint64_t
+SpriteCache::hashAsset(const QByteArray &contents)
+{
+    return fnv1a(contents.constData(), size_t(contents.size()));
+}
+
+QImage
+SpriteCache::load(const Key &key)
+{
+    TRACE_SPAN("SpriteCache::load");
+
+    if (!Config::Settings::sprite_cache) { return QImage(); }
+
+    QFile file(path(key));
+    if (!file.open(QIODevice::ReadOnly)) { return QImage(); }
+
+    Header header;
+    if (file.read(reinterpret_cast<char *>(&header), sizeof(header))
+            != qint64(sizeof(header))
+        || std::memcmp(header.magic, MAGIC, sizeof(MAGIC)) != 0
+        || header.version != VERSION || header.asset_hash != key.asset_hash
+        || header.tint != key.tint || header.width != key.size.width()
+        || header.height != key.size.height()
+        || header.pixel_ratio != key.pixel_ratio) {
+        return QImage();
+    }
+
+    QImage image(key.size, QImage::Format_ARGB32_Premultiplied);
+
+    const qint64 bytes = qint64(image.sizeInBytes());
+    if (image.isNull() || image.bytesPerLine() != header.bytes_per_line
+        || file.read(reinterpret_cast<char *>(image.bits()), bytes) != bytes) {
+        return QImage();
+    }
+
+    image.setDevicePixelRatio(key.pixel_ratio);
+
+    return image;
+}
+
+void
+SpriteCache::store(const Key &key, const QImage &image, const void *slot)
+{
+    if (!Config::Settings::sprite_cache || image.isNull()
+        || image.format() != QImage::Format_ARGB32_Premultiplied) {
+        return;
+    }
+
+    std::lock_guard<std::mutex> guard(Pending::lock);
+
+    // the image is shared, not copied
+    Pending::entries[slot] = Pending::Entry { key, image };
+    ++Pending::generation;
+
+    if (Pending::flushing) { return; }
+    Pending::flushing = true;
+
+    QThreadPool::globalInstance()->start(&SpriteCache::flush);
+}
+
+void
+SpriteCache::flush()
+{
+    TRACE_THREAD("sprite store");
+
+    std::unordered_map<const void *, Pending::Entry> batch;
+
+    for (uint64_t seen = UINT64_MAX;;) {
+        QThread::msleep(STORE_DELAY_MS);
+
+        std::lock_guard<std::mutex> guard(Pending::lock);
+
+        if (Pending::generation == seen) {
+            batch.swap(Pending::entries);
+            Pending::flushing = false;
+            break;
+        }
+
+        seen = Pending::generation;
+    }
+
+    if (!QDir().mkpath(directory())) { return; }
+
+    for (const auto &[slot, entry] : batch) { write(entry.key, entry.image); }
+
+    prune();
+}
+
+void
+SpriteCache::write(const Key &key, const QImage &image)
+{
+    TRACE_SPAN("SpriteCache::write");
+
+    Header header;
+    std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+    header.version        = VERSION;
+    header.asset_hash     = key.asset_hash;
+    header.tint           = key.tint;
+    header.width          = image.width();
+    header.height         = image.height();
+    header.bytes_per_line = int32_t(image.bytesPerLine());
+    header.pixel_ratio    = key.pixel_ratio;
+
+    QSaveFile file(path(key));
+    if (!file.open(QIODevice::WriteOnly)) { return; }
+
+    file.write(reinterpret_cast<const char *>(&header), sizeof(header));
+    file.write(reinterpret_cast<const char *>(image.constBits()),
+               qint64(image.sizeInBytes()));
+
+    if (!file.commit()) {
+        qWarning("SpriteCache: failed to write '%s'",
+                 qPrintable(file.fileName()));
+    }
+}
+
+void
+SpriteCache::prune()
+{
+    QDir parent(directory());
+    parent.cdUp();
+
+    const QString current = QDir(directory()).dirName();
+    const QStringList versions
+        = parent.entryList({ "sprites-v*" }, QDir::Dirs | QDir::NoDotAndDotDot);
+
+    for (const QString &name : versions) {
+        if (name != current) {
+            QDir(parent.filePath(name)).removeRecursively();
+        }
+    }
+
+    // newest first
+    const QFileInfoList entries = QDir(directory()).entryInfoList(
+        { "*.sprite" }, QDir::Files, QDir::Time);
+
+    for (qsizetype i = MAX_ENTRIES; i < entries.size(); i++) {
+        QFile::remove(entries[i].filePath());
+    }
+}
+
+bool
+SpriteCache::isEmpty()
+{
+    return QDir(directory()).isEmpty(QDir::Files);
+}
+
+QImage
+SpriteCache::shared(const Key &key)
+{
+    std::lock_guard<std::mutex> guard(Shared::lock);
+
+    const auto entry = Shared::entries.find(keyHash(key));
+    if (entry == Shared::entries.end() || !sameKey(entry->second.key, key)) {
+        return QImage();
+    }
+
+    return entry->second.image;
+}
+
+void
+SpriteCache::share(const Key &key, const QImage &image)
+{
+    if (image.isNull()) { return; }
+
+    std::lock_guard<std::mutex> guard(Shared::lock);
+
+    // a detached image is only held by the table, every renderer that used
+    // it has moved on to another size or tint
+    for (auto entry = Shared::entries.begin();
+         entry != Shared::entries.end();) {
+        if (entry->second.image.isDetached()) {
+            entry = Shared::entries.erase(entry);
+        } else {
+            ++entry;
+        }
+    }
+
+    Shared::entries[keyHash(key)] = Shared::Entry { key, image };
+}
+
+QString
+SpriteCache::directory()
+{
+    return QStandardPaths::writableLocation(QStandardPaths::CacheLocation)
+           + QString("/sprites-v%1").arg(VERSION);
+}
+
+QString
+SpriteCache::path(const Key &key)
+{
+    return directory()
+           + QString("/%1.sprite").arg(qulonglong(keyHash(key)), 16, 16,
+                                       QChar('0'));
+}
@@ -0,0 +1,73 @@
+//-- Description -------------------------------------------------------------/
+// On-disk cache of the tinted and scaled sprites, in the user's cache        /
+// directory. An entry is keyed by the hash of the sprite's file, the tint,   /
+// the device pixel size and the pixel ratio, and holds the raw premultiplied /
+// pixels, so loading it is a single read with no decoding. The format is     /
+// versioned, entries of another version are never read. Writes are done in  /
+// the background once the sprites stop changing (e.g. a window resize).      /
+// Sprites in use are also shared in memory, so boards with the same tint and /
+// size hold a single copy of the pixels.                                     /
+//----------------------------------------------------------------------------/
+
+#ifndef SPRITECACHE_H
+#define SPRITECACHE_H
+
+#include <QByteArray>
+#include <QImage>
+#include <QRgb>
+#include <QSize>
+#include <QString>
+#include <cstdint>
+
+class SpriteCache {
+public:
+    // bump when the way sprites are tinted or scaled changes
+    static constexpr uint32_t VERSION = 1;
+
+    static constexpr size_t MAX_ENTRIES    = 128;    // oldest are removed
+    static constexpr int    STORE_DELAY_MS = 1000;
+
+    struct Key {
+        uint64_t asset_hash  = 0;    // of the sprite's file
+        QRgb     tint        = 0;
+        QSize    size;               // device pixels
+        qreal    pixel_ratio = 1;
+    };
+
+    // hash of a sprite's file contents
+    static uint64_t hashAsset(const QByteArray &contents);
+
+    // the cached sprite, or a null image if there is none (or it's invalid)
+    static QImage load(const Key &key);
+
+    // write a sprite to the cache once no sprite has been stored for
+    // STORE_DELAY_MS. a sprite replaces the pending one of the same 'slot',
+    // so only the last size of a resize is written
+    static void store(const Key &key, const QImage &image, const void *slot);
+
+    // true if there is nothing cached for this version
+    static bool isEmpty();
+
+    // the sprite of 'key' a renderer is already using, or a null image. the
+    // pixels are shared, not copied
+    static QImage shared(const Key &key);
+
+    // let other renderers use a sprite, it's dropped once no renderer holds
+    // it anymore
+    static void share(const Key &key, const QImage &image);
+
+private:
+    // waits for the stores to settle and writes the pending sprites, on a
+    // pool thread
+    static void flush();
+
+    static void write(const Key &key, const QImage &image);
+
+    // remove other versions, and the oldest entries over MAX_ENTRIES
+    static void prune();
+
+    static QString directory();
+    static QString path(const Key &key);
+};
+
+#endif    // SPRITECACHE_H
@@ -0,0 +1,63 @@
+//-- Description -------------------------------------------------------------/
+// methods that record and print the startup stages                           /
+//----------------------------------------------------------------------------/
+
+#include "startup.h"
+
+#include <QCoreApplication>
+#include <QTimer>
+#include <cstdio>
+
+void
+Startup::begin()
+{
+    clock.start();
+    marks.clear();
+    first_frame_ms = -1;
+}
+
+void
+Startup::mark(const char *stage)
+{
+    marks.emplace_back(stage, elapsedMs());
+}
+
+void
+Startup::firstFrame()
+{
+    if (first_frame_ms >= 0) { return; }
+
+    first_frame_ms = elapsedMs();
+    marks.emplace_back("first frame", first_frame_ms);
+}
+
+void
+Startup::ready()
+{
+    mark("ready");
+
+    if (!exit_when_ready) { return; }
+
+    report();
+
+    // let the current event finish before quitting
+    QTimer::singleShot(0,
+                       QCoreApplication::instance(),
+                       &QCoreApplication::quit);
+}
+
+void
+Startup::report()
+{
+    for (const auto &[stage, ms] : marks) {
+        fprintf(stderr, "startup: %-20s %9.2f ms\n", stage, ms);
+    }
+
+    fprintf(stderr, "startup: time to first frame %.2f ms\n", first_frame_ms);
+}
+
+double
+Startup::elapsedMs()
+{
+    return clock.isValid() ? clock.nsecsElapsed() / 1e6 : 0;
+}
@@ -0,0 +1,50 @@
+//-- Description -------------------------------------------------------------/
+// Measures the startup of the game. The clock starts in main(), every stage  /
+// of the staged initialisation is marked on it, and the time to the first   /
+// painted frame of the main window is kept so startup regressions can be     /
+// tracked (see '--startup-time').                                            /
+//----------------------------------------------------------------------------/
+
+#ifndef STARTUP_H
+#define STARTUP_H
+
+#include <QElapsedTimer>
+#include <utility>
+#include <vector>
+
+class Startup {
+public:
+    // start the clock, as early in main() as possible
+    static void begin();
+
+    // the time a stage has finished at, 'stage' must be a string literal
+    static void mark(const char *stage);
+
+    // the main window has painted it's first frame, only the first call
+    // is kept
+    static void firstFrame();
+
+    // every stage has run, quits the application if it should exit when
+    // ready
+    static void ready();
+
+    // -1 until the first frame
+    static double timeToFirstFrameMs() { return first_frame_ms; }
+
+    // print the stages and quit once the game is ready
+    static void setExitWhenReady(bool exit) { exit_when_ready = exit; }
+
+    // print every stage to stderr
+    static void report();
+
+private:
+    static inline QElapsedTimer clock;
+    static inline double        first_frame_ms  = -1;
+    static inline bool          exit_when_ready = false;
+
+    static inline std::vector<std::pair<const char *, double>> marks;
+
+    static double elapsedMs();
+};
+
+#endif    // STARTUP_H
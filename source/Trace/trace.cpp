@@ -0,0 +1,211 @@
+//-- Description -------------------------------------------------------------/
+// methods that record the spans into the per-thread rings, and write them as /
+// Chrome trace JSON. a ring has a single writer, it's own thread, and is     /
+// only read by dump(), so recording never takes a lock.                      /
+//----------------------------------------------------------------------------/
+
+#include "trace.h"
+
+#include <QCoreApplication>
+#include <QFile>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace {
+    static_assert((Trace::RING_SIZE & (Trace::RING_SIZE - 1)) == 0,
+                  "the ring size must be a power of two");
+
+    const std::chrono::steady_clock::time_point START
+        = std::chrono::steady_clock::now();
+
+    struct Ring {
+        struct Event {
+            const char *name;
+            int64_t     start;       // ns
+            int64_t     duration;    // ns
+        };
+
+        Event events[Trace::RING_SIZE];
+
+        // spans recorded, the slot of a span is it's index modulo the size
+        std::atomic<uint64_t> head = 0;
+
+        std::atomic<const char *> name = nullptr;
+        uint32_t                  tid  = 0;
+    };
+
+    // every ring, a thread only takes the lock when it starts and exits
+    struct Rings {
+        static inline std::mutex                         lock;
+        static inline std::vector<std::shared_ptr<Ring>> live;
+        static inline std::deque<std::shared_ptr<Ring>>  retired;
+        static inline uint32_t                           next_tid = 1;
+    };
+
+    // the ring of a thread, kept for dump() when the thread exits
+    struct Local {
+        std::shared_ptr<Ring> ring = std::make_shared<Ring>();
+
+        Local()
+        {
+            std::lock_guard<std::mutex> guard(Rings::lock);
+            ring->tid = Rings::next_tid++;
+            Rings::live.push_back(ring);
+        }
+
+        ~Local()
+        {
+            std::lock_guard<std::mutex> guard(Rings::lock);
+
+            for (auto it = Rings::live.begin(); it != Rings::live.end(); ++it) {
+                if (*it == ring) {
+                    Rings::live.erase(it);
+                    break;
+                }
+            }
+
+            Rings::retired.push_back(ring);
+            if (Rings::retired.size() > Trace::RETIRED_MAX) {
+                Rings::retired.pop_front();
+            }
+        }
+    };
+
+    Ring &
+    localRing()
+    {
+        thread_local Local local;
+        return *local.ring;
+    }
+
+    // copy the spans still in a ring, it's thread may keep recording
+    std::vector<Ring::Event>
+    readRing(const Ring &ring)
+    {
+        const uint64_t head  = ring.head.load(std::memory_order_acquire);
+        const uint64_t first = head > Trace::RING_SIZE
+                                   ? head - Trace::RING_SIZE
+                                   : 0;
+
+        std::vector<Ring::Event> events;
+        events.reserve(head - first);
+
+        for (uint64_t i = first; i < head; i++) {
+            events.push_back(ring.events[i & (Trace::RING_SIZE - 1)]);
+        }
+
+        // a slot the writer may have reused while it was copied is dropped.
+        // the slot of 'now_head' is written before the head is published,
+        // so the span at now_head - RING_SIZE may be torn as well
+        const uint64_t now_head = ring.head.load(std::memory_order_acquire);
+        if (now_head >= Trace::RING_SIZE + first) {
+            const uint64_t stale = now_head - Trace::RING_SIZE - first + 1;
+            events.erase(events.begin(),
+                         events.begin()
+                             + std::min<uint64_t>(stale, events.size()));
+        }
+
+        return events;
+    }
+}    // namespace
+
+int64_t
+Trace::now()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+               std::chrono::steady_clock::now() - START)
+        .count();
+}
+
+void
+Trace::record(const char *name, int64_t start, int64_t duration)
+{
+    Ring          &ring = localRing();
+    const uint64_t head = ring.head.load(std::memory_order_relaxed);
+
+    ring.events[head & (RING_SIZE - 1)] = { name, start, duration };
+    ring.head.store(head + 1, std::memory_order_release);
+}
+
+void
+Trace::setThreadName(const char *name)
+{
+    localRing().name.store(name, std::memory_order_relaxed);
+}
+
+void
+Trace::setOutput(const QString &path)
+{
+    output_path = path;
+}
+
+bool
+Trace::dump()
+{
+    return !output_path.isEmpty() && dump(output_path);
+}
+
+bool
+Trace::dump(const QString &path)
+{
+    std::vector<std::shared_ptr<Ring>> rings;
+    {
+        std::lock_guard<std::mutex> guard(Rings::lock);
+        rings.assign(Rings::retired.begin(), Rings::retired.end());
+        rings.insert(rings.end(), Rings::live.begin(), Rings::live.end());
+    }
+
+    const qint64 pid = QCoreApplication::applicationPid();
+
+    QJsonArray trace_events;
+
+    for (const std::shared_ptr<Ring> &ring : rings) {
+        const char *name = ring->name.load(std::memory_order_relaxed);
+
+        trace_events.append(QJsonObject {
+            { "name", "thread_name" },
+            { "ph", "M" },
+            { "pid", pid },
+            { "tid", qint64(ring->tid) },
+            { "args",
+              QJsonObject { { "name",
+                              name != nullptr
+                                  ? QString(name)
+                                  : QString("thread %1").arg(ring->tid) } } },
+        });
+
+        // the format takes microseconds
+        for (const Ring::Event &event : readRing(*ring)) {
+            trace_events.append(QJsonObject {
+                { "name", QLatin1String(event.name) },
+                { "ph", "X" },
+                { "pid", pid },
+                { "tid", qint64(ring->tid) },
+                { "ts", event.start / 1e3 },
+                { "dur", event.duration / 1e3 },
+            });
+        }
+    }
+
+    const QByteArray json
+        = QJsonDocument(QJsonObject { { "traceEvents", trace_events },
+                                      { "displayTimeUnit", "ms" } })
+              .toJson(QJsonDocument::Compact);
+
+    QFile file(path);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)
+        || file.write(json) != json.size()) {
+        qWarning("can't write the trace to '%s'", qPrintable(path));
+        return false;
+    }
+
+    return true;
+}
@@ -0,0 +1,72 @@
+//-- Description -------------------------------------------------------------/
+// Scoped trace spans, written as Chrome trace JSON (chrome://tracing or      /
+// ui.perfetto.dev). Every thread records into it's own fixed size ring, so   /
+// a span costs two clock reads and a store, and the oldest spans are         /
+// overwritten. The macros are only compiled in with HANOI_TRACE, the         /
+// 'HANOI_TRACE' CMake option.                                                /
+//----------------------------------------------------------------------------/
+
+#ifndef TRACE_H
+#define TRACE_H
+
+#include <QString>
+#include <cstdint>
+
+class Trace {
+public:
+    // spans kept per thread, a power of two
+    static constexpr size_t RING_SIZE = size_t(1) << 15;
+
+    // rings of the threads that have exited, the oldest is dropped
+    static constexpr size_t RETIRED_MAX = 4;
+
+    // records the time from it's construction to it's destruction, 'name'
+    // must be a string literal
+    class Span {
+    public:
+        explicit Span(const char *name) : m_name(name), m_start(now()) {}
+
+        ~Span() { record(m_name, m_start, now() - m_start); }
+
+        Span(const Span &)            = delete;
+        Span &operator=(const Span &) = delete;
+
+    private:
+        const char   *m_name;
+        const int64_t m_start;
+    };
+
+    // name the calling thread in the trace, 'name' must be a string literal
+    static void setThreadName(const char *name);
+
+    // the file 'dump()' writes to, empty: nowhere
+    static void setOutput(const QString &path);
+
+    // write every span still in the rings to the output file
+    static bool dump();
+    static bool dump(const QString &path);
+
+    // ns since the process started
+    static int64_t now();
+
+private:
+    static inline QString output_path;
+
+    static void record(const char *name, int64_t start, int64_t duration);
+};
+
+#ifdef HANOI_TRACE
+    #define TRACE_CONCAT_(a, b) a##b
+    #define TRACE_CONCAT(a, b)  TRACE_CONCAT_(a, b)
+
+    // time the rest of the enclosing scope
+    #define TRACE_SPAN(name) \
+        const Trace::Span TRACE_CONCAT(trace_span_, __LINE__)(name)
+
+    #define TRACE_THREAD(name) Trace::setThreadName(name)
+#else
+    #define TRACE_SPAN(name)   ((void)0)
+    #define TRACE_THREAD(name) ((void)0)
+#endif    // HANOI_TRACE
+
+#endif    // TRACE_H
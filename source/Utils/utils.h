@@ -4,8 +4,11 @@
 #ifndef UTILS_H
 #define UTILS_H
 
+#include <QColor>
 #include <QFile>
+#include <QImage>
 #include <QString>
+#include <array>
 #include <string>
 #include <tuple>
 
@@ -35,11 +38,42 @@ namespace Utils {
     // convert the numeric labels of stacks to alphabets
     static inline QString numToChar(size_t n)
     {
-        std::string str;
-        str += char('A' + n);
-        return QString::fromStdString(str);
+        return QString(QChar(char16_t('A' + n)));
     };
 
+    // tint an image by overlaying 'color' on every pixel. the overlay blend
+    // of every channel value is precomputed into a lookup table, so a tint
+    // is a single remapping pass over the pixels; the alpha is kept as is.
+    static inline QImage tintImage(const QImage &source, const QColor &color)
+    {
+        const auto overlay = [](int c, int d) {
+            return (2 * d < 255) ? (2 * c * d) / 255
+                                 : 255 - (2 * (255 - c) * (255 - d)) / 255;
+        };
+
+        std::array<uchar, 256> r_lut, g_lut, b_lut;
+        for (int d = 0; d < 256; d++) {
+            r_lut[d] = overlay(color.red(), d);
+            g_lut[d] = overlay(color.green(), d);
+            b_lut[d] = overlay(color.blue(), d);
+        }
+
+        QImage tinted = source.convertToFormat(QImage::Format_ARGB32);
+
+        for (int y = 0; y < tinted.height(); y++) {
+            QRgb *line = reinterpret_cast<QRgb *>(tinted.scanLine(y));
+            for (int x = 0; x < tinted.width(); x++) {
+                const QRgb px = line[x];
+                line[x]       = qRgba(r_lut[qRed(px)],
+                                g_lut[qGreen(px)],
+                                b_lut[qBlue(px)],
+                                qAlpha(px));
+            }
+        }
+
+        return tinted;
+    }
+
     // load and get stylesheet
     static inline QString getDefaultStylesheet()
     {
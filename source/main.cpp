@@ -1,12 +1,155 @@
+#include "Config/config.h"
+#include "FrameExporter/frameexporter.h"
 #include "MainWindow/mainwindow.h"
+#include "Metrics/metrics.h"
+#include "Random/random.h"
+#include "Replay/replay.h"
+#include "Startup/startup.h"
+#include "Trace/trace.h"
 
 #include <QApplication>
+#include <QCommandLineParser>
+
+// render a solver run, or the game of a replay file, to png frames instead
+// of starting the game, this works headless when ran with '-platform
+// offscreen'
+static int
+exportFrames(const QCommandLineParser &parser)
+{
+    FrameExporter::Options options;
+
+    const QStringList size = parser.value("size").split('x');
+
+    options.directory = parser.value("export-frames");
+    options.threads   = parser.value("threads").toUInt();
+
+    if (size.size() == 2) {
+        options.frame_size = QSize(size[0].toInt(), size[1].toInt());
+    }
+
+    // a replay needs a directory to be rendered to
+    if (options.directory.isEmpty() || options.frame_size.isEmpty()) {
+        qCritical("invalid export options");
+        return 1;
+    }
+
+    // the board and the moves of the recorded game
+    if (parser.isSet("export-replay")) {
+        const QString path = parser.value("export-replay");
+
+        Replay                    replay;
+        std::vector<Replay::Move> moves;
+        if (!replay.open(path) || !replay.moves(moves)) {
+            qCritical("'%s' is not a valid replay", qPrintable(path));
+            return 1;
+        }
+
+        options.stack_amount = replay.info().stack_amount;
+        options.slice_amount = replay.info().slice_amount;
+        options.goal         = replay.info().goal;
+
+        return FrameExporter::exportFrames(options, moves) ? 0 : 1;
+    }
+
+    options.stack_amount = parser.value("stacks").toULongLong();
+    options.slice_amount = parser.value("slices").toULongLong();
+    options.goal         = options.stack_amount - 1;
+
+    if (options.stack_amount < 3 || options.stack_amount > Config::STACK_MAX) {
+        qCritical("invalid export options");
+        return 1;
+    }
+
+    if (options.slice_amount < 1
+        || options.slice_amount > FrameExporter::SLICE_MAX) {
+        qCritical("can't export %zu slices, the range is 1-%zu",
+                  options.slice_amount,
+                  FrameExporter::SLICE_MAX);
+        return 1;
+    }
+
+    return FrameExporter::exportFrames(options,
+                                       FrameExporter::getSolverMoves(options))
+               ? 0
+               : 1;
+}
 
 int
 main(int argc, char *argv[])
 {
+    Startup::begin();
+    TRACE_THREAD("gui");
+
     QApplication a(argc, argv);
-    MainWindow   w;
+
+    QCommandLineParser parser;
+    parser.addHelpOption();
+    parser.addOptions({
+        { "export-frames", "Render a solver run as PNG frames.", "dir" },
+        { "export-replay",
+          "Render the game of a replay file instead of a solver run.",
+          "file" },
+        { "stacks", "Amount of stacks to export.", "n", "3" },
+        { "slices", "Amount of slices to export, at most 16.", "n", "5" },
+        { "size", "Size of the exported frames.", "WxH", "1280x720" },
+        { "threads", "Amount of render threads, 0 for all.", "n", "0" },
+        { "startup-time", "Print the startup stages and quit when ready." },
+        { "seed",
+          "Seed of the session, the same seed plays the same games. Random "
+          "if 0.",
+          "n",
+          "0" },
+        { "metrics-file",
+          "Write the metrics in the OpenMetrics format to a file.",
+          "file" },
+        { "metrics-socket",
+          "Serve the metrics in the OpenMetrics format on a unix socket.",
+          "path" },
+        { "metrics-interval",
+          "Seconds between the metrics file updates.",
+          "s",
+          "10" },
+#ifdef HANOI_TRACE
+        { "trace",
+          "Write the trace spans to a Chrome trace file on exit, and when "
+          "F4 is pressed.",
+          "file" },
+#endif    // HANOI_TRACE
+    });
+    parser.process(a);
+
+#ifdef HANOI_TRACE
+    Trace::setOutput(parser.value("trace"));
+#endif    // HANOI_TRACE
+
+    if (parser.isSet("export-frames") || parser.isSet("export-replay")) {
+        return exportFrames(parser);
+    }
+
+    Startup::setExitWhenReady(parser.isSet("startup-time"));
+
+    Random::setSessionSeed(parser.value("seed").toULongLong(nullptr, 0));
+
+    Metrics::Options metrics;
+    metrics.file   = parser.value("metrics-file");
+    metrics.socket = parser.value("metrics-socket");
+    metrics.interval_ms
+        = int(parser.value("metrics-interval").toDouble() * 1000);
+
+    if (!Metrics::start(metrics)) {
+        qCritical("can't export the metrics");
+        return 1;
+    }
+
+    Startup::mark("application");
+
+    MainWindow w;
     w.show();
-    return a.exec();
+
+    const int status = a.exec();
+
+    Metrics::stop();
+    Trace::dump();
+
+    return status;
 }
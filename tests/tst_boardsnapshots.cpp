@@ -0,0 +1,155 @@
+//-- Description -------------------------------------------------------------/
+// tests of the timeline snapshots: taken on the interval, kept over a redo,  /
+// and replaced when a new move is made after an undo.                        /
+//----------------------------------------------------------------------------/
+
+#include "../source/MoveHistory/boardsnapshots.h"
+#include "../source/MoveHistory/movehistory.h"
+
+#include <QtTest>
+#include <algorithm>
+
+namespace {
+    constexpr size_t SLICES = 3;
+
+    // the history and the snapshots, the way GameView records a move. every
+    // snapshot is filled with 'line', the line of moves it was taken on
+    struct Game {
+        MoveHistory    history;
+        BoardSnapshots snapshots;
+
+        Game() { snapshots.reset(SLICES); }
+
+        // returns false if the move was a redo
+        bool play(size_t source, size_t dest, uint8_t line)
+        {
+            const bool is_new = history.record(source, dest);
+
+            uint8_t *const snapshot
+                = snapshots.record(history.position(), is_new);
+            if (snapshot != nullptr) { std::fill_n(snapshot, SLICES, line); }
+
+            return is_new;
+        }
+
+        void playUntil(size_t position, uint8_t line)
+        {
+            while (history.position() < position) { play(0, 1, line); }
+        }
+
+        void undoUntil(size_t position)
+        {
+            while (history.position() > position) {
+                history.undoMove();
+                history.stepBack();
+            }
+        }
+
+        uint8_t lineOf(size_t snapshot) const
+        {
+            return snapshots.at(snapshot)[0];
+        }
+    };
+}    // namespace
+
+class TestBoardSnapshots : public QObject {
+    Q_OBJECT
+
+private slots:
+    void interval();
+    void redoKeepsSnapshot();
+    void divergeOnBoundary();
+    void divergeBeforeBoundary();
+    void divergeAfterBoundary();
+};
+
+void
+TestBoardSnapshots::interval()
+{
+    Game game;
+    QCOMPARE(game.snapshots.count(), size_t(1));
+    QCOMPARE(game.lineOf(0), uint8_t(0));
+
+    game.playUntil(2 * BoardSnapshots::INTERVAL - 1, 1);
+    QCOMPARE(game.snapshots.count(), size_t(2));
+
+    game.playUntil(2 * BoardSnapshots::INTERVAL, 1);
+    QCOMPARE(game.snapshots.count(), size_t(3));
+    QCOMPARE(game.lineOf(2), uint8_t(1));
+
+    QCOMPARE(game.snapshots.closest(0), size_t(0));
+    QCOMPARE(game.snapshots.closest(BoardSnapshots::INTERVAL - 1), size_t(0));
+    QCOMPARE(game.snapshots.closest(BoardSnapshots::INTERVAL), size_t(1));
+    QCOMPARE(game.snapshots.closest(100 * BoardSnapshots::INTERVAL),
+             size_t(2));
+}
+
+void
+TestBoardSnapshots::redoKeepsSnapshot()
+{
+    Game game;
+    game.playUntil(2 * BoardSnapshots::INTERVAL, 1);
+
+    game.undoUntil(2 * BoardSnapshots::INTERVAL - 1);
+
+    // the same move again is a redo onto the same board
+    QVERIFY(!game.play(0, 1, 2));
+    QCOMPARE(game.snapshots.count(), size_t(3));
+    QCOMPARE(game.lineOf(2), uint8_t(1));
+}
+
+// undo from 128 to 127, then a different move lands on 128 again: the
+// snapshot of the discarded line must be replaced
+void
+TestBoardSnapshots::divergeOnBoundary()
+{
+    Game game;
+    game.playUntil(2 * BoardSnapshots::INTERVAL, 1);
+
+    game.undoUntil(2 * BoardSnapshots::INTERVAL - 1);
+
+    QVERIFY(game.play(1, 0, 2));
+    QCOMPARE(game.history.size(), 2 * BoardSnapshots::INTERVAL);
+    QCOMPARE(game.snapshots.count(), size_t(3));
+    QCOMPARE(game.lineOf(1), uint8_t(1));
+    QCOMPARE(game.lineOf(2), uint8_t(2));
+}
+
+void
+TestBoardSnapshots::divergeBeforeBoundary()
+{
+    Game game;
+    game.playUntil(3 * BoardSnapshots::INTERVAL + 5, 1);
+    QCOMPARE(game.snapshots.count(), size_t(4));
+
+    // the snapshots after the fork are dropped at once
+    game.undoUntil(BoardSnapshots::INTERVAL + 5);
+
+    QVERIFY(game.play(1, 0, 2));
+    QCOMPARE(game.snapshots.count(), size_t(2));
+    QCOMPARE(game.lineOf(1), uint8_t(1));
+
+    // and taken again on the new line
+    game.playUntil(3 * BoardSnapshots::INTERVAL, 2);
+    QCOMPARE(game.snapshots.count(), size_t(4));
+    QCOMPARE(game.lineOf(2), uint8_t(2));
+    QCOMPARE(game.lineOf(3), uint8_t(2));
+}
+
+// the board on the boundary is shared by both lines, and kept
+void
+TestBoardSnapshots::divergeAfterBoundary()
+{
+    Game game;
+    game.playUntil(2 * BoardSnapshots::INTERVAL, 1);
+
+    game.undoUntil(BoardSnapshots::INTERVAL);
+
+    QVERIFY(game.play(1, 0, 2));
+    QCOMPARE(game.snapshots.count(), size_t(2));
+    QCOMPARE(game.lineOf(1), uint8_t(1));
+}
+
+QTEST_APPLESS_MAIN(TestBoardSnapshots)
+
+#include "tst_boardsnapshots.moc"
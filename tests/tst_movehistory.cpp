@@ -0,0 +1,203 @@
+//-- Description -------------------------------------------------------------/
+// tests of the move history: undo, redo and a new line of moves across the   /
+// segments spilled to disk, and the moves dropped without a spill file.      /
+//----------------------------------------------------------------------------/
+
+#include "../source/MoveHistory/movehistory.h"
+
+#include <QtTest>
+
+namespace {
+    // a move that depends on it's index, the history doesn't check them
+    MoveHistory::Move
+    moveOf(size_t i)
+    {
+        return MoveHistory::Move(i % 5, (i % 5 + 1 + (i / 5) % 4) % 5);
+    }
+
+    // a move that differs from moveOf(i)
+    MoveHistory::Move
+    otherMoveOf(size_t i)
+    {
+        const MoveHistory::Move move = moveOf(i);
+        return MoveHistory::Move(move.second, move.first);
+    }
+
+    void
+    recordMoves(MoveHistory &history, size_t begin, size_t end)
+    {
+        for (size_t i = begin; i < end; i++) {
+            const MoveHistory::Move move = moveOf(i);
+            history.record(move.first, move.second);
+        }
+    }
+}    // namespace
+
+class TestMoveHistory : public QObject {
+    Q_OBJECT
+
+private slots:
+    void undoRedo();
+    void undoRedoAcrossSpill();
+    void divergeAcrossSpill();
+    void dropWithoutSpill();
+};
+
+void
+TestMoveHistory::undoRedo()
+{
+    MoveHistory history;
+    QVERIFY(!history.canUndo());
+    QVERIFY(!history.canRedo());
+
+    recordMoves(history, 0, 10);
+    QCOMPARE(history.position(), size_t(10));
+    QCOMPARE(history.size(), size_t(10));
+
+    for (size_t i = 10; i > 6; i--) {
+        QVERIFY(history.undoMove() == moveOf(i - 1));
+        history.stepBack();
+    }
+
+    QCOMPARE(history.position(), size_t(6));
+    QCOMPARE(history.size(), size_t(10));
+    QVERIFY(history.canRedo());
+    QVERIFY(history.redoMove() == moveOf(6));
+
+    history.stepForward();
+    QCOMPARE(history.position(), size_t(7));
+
+    // making the next undone move again is a redo
+    recordMoves(history, 7, 8);
+    QCOMPARE(history.position(), size_t(8));
+    QCOMPARE(history.size(), size_t(10));
+
+    std::vector<MoveHistory::Move> moves;
+    QVERIFY(history.moves(moves));
+    QCOMPARE(moves.size(), size_t(8));
+    for (size_t i = 0; i < moves.size(); i++) {
+        QVERIFY(moves[i] == moveOf(i));
+    }
+}
+
+void
+TestMoveHistory::undoRedoAcrossSpill()
+{
+    // the limit is raised to a single segment
+    MoveHistory history(0);
+    history.setSpill(true);
+
+    const size_t total = 2 * MoveHistory::SEGMENT + 100;
+    recordMoves(history, 0, total);
+
+    QCOMPARE(history.size(), total);
+
+    // every move can still be read, the spilled ones included
+    MoveHistory::Move move;
+    for (const size_t i : { size_t(0), MoveHistory::SEGMENT, total - 1 }) {
+        QVERIFY(history.moveAt(i, move));
+        QVERIFY(move == moveOf(i));
+    }
+
+    // undo into the spilled segments, they are read back
+    const size_t back_to = MoveHistory::SEGMENT / 2;
+    while (history.position() > back_to) {
+        QVERIFY(history.canUndo());
+        QVERIFY(history.undoMove() == moveOf(history.position() - 1));
+        history.stepBack();
+    }
+
+    QCOMPARE(history.size(), total);
+
+    // and redo over them again
+    while (history.position() < total) {
+        QVERIFY(history.canRedo());
+        QVERIFY(history.redoMove() == moveOf(history.position()));
+        history.stepForward();
+    }
+
+    std::vector<MoveHistory::Move> moves;
+    QVERIFY(history.moves(moves));
+    QCOMPARE(moves.size(), total);
+    for (size_t i = 0; i < total; i++) { QVERIFY(moves[i] == moveOf(i)); }
+}
+
+void
+TestMoveHistory::divergeAcrossSpill()
+{
+    MoveHistory history(0);
+    history.setSpill(true);
+
+    const size_t total = 2 * MoveHistory::SEGMENT + 100;
+    recordMoves(history, 0, total);
+
+    // undo past the start of the moves kept in memory
+    const size_t fork = MoveHistory::SEGMENT + 10;
+    while (history.position() > fork) {
+        history.undoMove();
+        history.stepBack();
+    }
+
+    // a different move discards the undone ones
+    const MoveHistory::Move other = otherMoveOf(fork);
+    history.record(other.first, other.second);
+
+    QCOMPARE(history.position(), fork + 1);
+    QCOMPARE(history.size(), fork + 1);
+    QVERIFY(!history.canRedo());
+
+    // the new line grows over the limit, and spills again
+    recordMoves(history, fork + 1, fork + MoveHistory::SEGMENT + 50);
+
+    const size_t size = history.size();
+    QCOMPARE(size, fork + MoveHistory::SEGMENT + 50);
+
+    std::vector<MoveHistory::Move> moves;
+    QVERIFY(history.moves(moves));
+    QCOMPARE(moves.size(), size);
+
+    for (size_t i = 0; i < size; i++) {
+        QVERIFY(moves[i] == (i == fork ? other : moveOf(i)));
+    }
+
+    // back to before the fork, through both spills
+    while (history.position() > fork - 1) {
+        QVERIFY(history.undoMove() == moves[history.position() - 1]);
+        history.stepBack();
+    }
+
+    QVERIFY(history.redoMove() == moveOf(fork - 1));
+}
+
+void
+TestMoveHistory::dropWithoutSpill()
+{
+    MoveHistory history(0);
+    history.setSpill(false);
+
+    const size_t total = MoveHistory::SEGMENT + 100;
+    recordMoves(history, 0, total);
+
+    QCOMPARE(history.size(), total);
+
+    // the oldest segment is gone
+    MoveHistory::Move move;
+    QVERIFY(!history.moveAt(0, move));
+    QVERIFY(history.moveAt(total - 1, move));
+    QVERIFY(move == moveOf(total - 1));
+
+    std::vector<MoveHistory::Move> moves;
+    QVERIFY(!history.moves(moves));
+
+    // the moves still in memory can be undone, and no more
+    while (history.canUndo()) {
+        QVERIFY(history.undoMove() == moveOf(history.position() - 1));
+        history.stepBack();
+    }
+
+    QCOMPARE(history.position(), MoveHistory::SEGMENT);
+}
+
+QTEST_APPLESS_MAIN(TestMoveHistory)
+
+#include "tst_movehistory.moc"
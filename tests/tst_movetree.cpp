@@ -0,0 +1,164 @@
+//-- Description -------------------------------------------------------------/
+// tests of the undo tree: branches kept after an undo, switching between     /
+// them, the board hashes, and the pruning of a full arena.                   /
+//----------------------------------------------------------------------------/
+
+#include "../source/MoveHistory/movetree.h"
+
+#include <QtTest>
+
+namespace {
+    using Move = MoveTree::Move;
+}    // namespace
+
+class TestMoveTree : public QObject {
+    Q_OBJECT
+
+private slots:
+    void undoRedo();
+    void branches();
+    void hashes();
+    void prune();
+};
+
+void
+TestMoveTree::undoRedo()
+{
+    MoveTree tree;
+    tree.reset(3);
+    QVERIFY(!tree.canUndo());
+    QVERIFY(!tree.canRedo());
+
+    tree.record(0, 2, 2);
+    tree.record(0, 1, 1);
+    QVERIFY(tree.undoMove() == Move(0, 1));
+
+    tree.stepBack();
+    QVERIFY(tree.canRedo());
+    QVERIFY(tree.redoMove() == Move(0, 1));
+
+    // the same move again follows the existing node
+    tree.record(0, 1, 1);
+    QVERIFY(!tree.canRedo());
+
+    tree.stepBack();
+    tree.stepBack();
+    QVERIFY(!tree.canUndo());
+
+    tree.stepForward();
+    tree.stepForward();
+    QVERIFY(tree.undoMove() == Move(0, 1));
+}
+
+void
+TestMoveTree::branches()
+{
+    MoveTree tree;
+    tree.reset(3);
+
+    tree.record(0, 2, 2);
+    tree.record(0, 1, 1);
+
+    // a different move after the undo starts a second branch
+    tree.stepBack();
+    tree.record(2, 1, 2);
+    QVERIFY(tree.undoMove() == Move(2, 1));
+
+    // both ways lead to the only other branch, at it's last position
+    const MoveTree::NodeId other = tree.siblingBranch(true);
+    QVERIFY(other != MoveTree::NONE);
+    QCOMPARE(tree.siblingBranch(false), other);
+
+    size_t            undo_count = 0;
+    std::vector<Move> redo;
+    tree.pathTo(other, undo_count, redo);
+
+    QCOMPARE(undo_count, size_t(1));
+    QCOMPARE(redo.size(), size_t(1));
+    QVERIFY(redo[0] == Move(0, 1));
+
+    // follow the path, the other branch is the current one after it
+    for (size_t i = 0; i < undo_count; i++) { tree.stepBack(); }
+    for (const Move &move : redo) {
+        tree.record(move.first, move.second, 1);
+    }
+
+    QVERIFY(tree.undoMove() == Move(0, 1));
+
+    // a tree without a fork has no other branch
+    MoveTree line;
+    line.reset(3);
+    line.record(0, 2, 2);
+    QCOMPARE(line.siblingBranch(true), MoveTree::NONE);
+}
+
+void
+TestMoveTree::hashes()
+{
+    MoveTree tree;
+    tree.reset(3);
+
+    const uint64_t start = MoveTree::sliceHash(0, 0)
+                           ^ MoveTree::sliceHash(1, 0)
+                           ^ MoveTree::sliceHash(2, 0);
+    QCOMPARE(tree.hash(), start);
+
+    // slice 2 (the smallest) moves from stack 0 to stack 2
+    tree.record(0, 2, 2);
+    QCOMPARE(tree.hash(),
+             MoveTree::sliceHash(0, 0) ^ MoveTree::sliceHash(1, 0)
+                 ^ MoveTree::sliceHash(2, 2));
+
+    tree.stepBack();
+    QCOMPARE(tree.hash(), start);
+
+    // the same board reached by another path has the same hash
+    tree.record(0, 1, 2);
+    tree.record(1, 2, 2);
+    QCOMPARE(tree.hash(),
+             MoveTree::sliceHash(0, 0) ^ MoveTree::sliceHash(1, 0)
+                 ^ MoveTree::sliceHash(2, 2));
+}
+
+void
+TestMoveTree::prune()
+{
+    // room for a handful of nodes only
+    MoveTree tree(8);
+    tree.reset(1);
+
+    // a branch of 3 moves, then a second one from the root
+    tree.record(0, 1, 0);
+    tree.record(1, 2, 0);
+    tree.record(2, 0, 0);
+
+    for (size_t i = 0; i < 3; i++) { tree.stepBack(); }
+
+    // the arena fills up, the other branch is pruned to make room
+    size_t depth = 0;
+    for (size_t i = 0; i < 12; i++, depth++) {
+        const size_t from = (i % 2 == 0) ? 0 : 2;
+        tree.record(from, 2 - from, 0);
+    }
+
+    QCOMPARE(tree.siblingBranch(true), MoveTree::NONE);
+
+    // the board hash survives the pruning
+    const uint64_t on_2 = MoveTree::sliceHash(0, 2);
+    const uint64_t on_0 = MoveTree::sliceHash(0, 0);
+    QCOMPARE(tree.hash(), (depth % 2 == 0) ? on_0 : on_2);
+
+    // the moves kept can still be undone
+    while (tree.canUndo()) {
+        const Move move = tree.undoMove();
+        tree.stepBack();
+        --depth;
+
+        QVERIFY(move.first == 0 || move.first == 2);
+        QCOMPARE(tree.hash(), (depth % 2 == 0) ? on_0 : on_2);
+    }
+}
+
+QTEST_APPLESS_MAIN(TestMoveTree)
+
+#include "tst_movetree.moc"
@@ -0,0 +1,351 @@
+//-- Description -------------------------------------------------------------/
+// tests of the replay files: a game written and read back, and the           /
+// truncated and corrupt files the reader must refuse.                        /
+//----------------------------------------------------------------------------/
+
+#include "../source/Random/random.h"
+#include "../source/Replay/replay.h"
+
+#include <QFile>
+#include <QTemporaryDir>
+#include <QtEndian>
+#include <QtTest>
+
+namespace {
+    // offsets of the file layout, see replay.cpp
+    constexpr qint64 HEADER_SIZE      = 56;
+    constexpr qint64 FOOTER_SIZE      = 24;
+    constexpr qint64 MOVE_COUNT_AT    = 48;
+    constexpr qint64 INDEX_ENTRY_SIZE = 16;
+
+    // a board as the stack label of every slice, the highest label on a
+    // stack is it's top slice
+    struct Board {
+        std::vector<uint8_t> slice_stacks;
+
+        explicit Board(size_t slice_amount) : slice_stacks(slice_amount, 0)
+        {
+        }
+
+        long long top(size_t stack) const
+        {
+            long long top = -1;
+            for (size_t label = 0; label < slice_stacks.size(); label++) {
+                if (slice_stacks[label] == stack) { top = label; }
+            }
+
+            return top;
+        }
+
+        // make the only legal move between the pair
+        bool move(size_t a, size_t b, Replay::Move &made)
+        {
+            const long long top_a = top(a), top_b = top(b);
+            if (a == b || (top_a < 0 && top_b < 0)) { return false; }
+
+            made = (top_a > top_b) ? Replay::Move(a, b) : Replay::Move(b, a);
+            slice_stacks[std::max(top_a, top_b)] = uint8_t(made.second);
+
+            return true;
+        }
+    };
+
+    // 'count' legal moves between random pairs of stacks
+    std::vector<Replay::Move>
+    randomGame(const Replay::Info &info, size_t count, uint64_t seed)
+    {
+        Random rng(seed);
+        Board  board(info.slice_amount);
+
+        std::vector<Replay::Move> moves;
+
+        while (moves.size() < count) {
+            const size_t a = rng.range(0, info.stack_amount - 1);
+            const size_t b = rng.range(0, info.stack_amount - 1);
+
+            Replay::Move made;
+            if (board.move(a, b, made)) { moves.push_back(made); }
+        }
+
+        return moves;
+    }
+
+    // the board after the first 'n' moves
+    std::vector<uint8_t>
+    boardAt(const Replay::Info              &info,
+            const std::vector<Replay::Move> &moves,
+            size_t                           n)
+    {
+        Board board(info.slice_amount);
+
+        Replay::Move made;
+        for (size_t i = 0; i < n; i++) {
+            board.move(moves[i].first, moves[i].second, made);
+        }
+
+        return board.slice_stacks;
+    }
+
+    QByteArray
+    readFile(const QString &path)
+    {
+        QFile file(path);
+        return file.open(QIODevice::ReadOnly) ? file.readAll() : QByteArray();
+    }
+
+    bool
+    writeFile(const QString &path, const QByteArray &data)
+    {
+        QFile file(path);
+        return file.open(QIODevice::WriteOnly | QIODevice::Truncate)
+               && file.write(data) == data.size();
+    }
+
+    void
+    setU64(QByteArray &data, qint64 offset, uint64_t value)
+    {
+        qToLittleEndian<uint64_t>(value, data.data() + offset);
+    }
+
+    uint64_t
+    getU64(const QByteArray &data, qint64 offset)
+    {
+        return qFromLittleEndian<uint64_t>(data.constData() + offset);
+    }
+}    // namespace
+
+class TestReplay : public QObject {
+    Q_OBJECT
+
+private slots:
+    void init();
+
+    void roundTrip();
+    void emptyGame();
+    void truncated();
+    void corruptCounts();
+    void corruptCheckpoint();
+    void illegalMove();
+
+private:
+    QTemporaryDir m_dir;
+    QString       m_path;
+
+    Replay::Info              m_info;
+    std::vector<Replay::Move> m_moves;
+};
+
+void
+TestReplay::init()
+{
+    QVERIFY(m_dir.isValid());
+
+    m_path = m_dir.filePath("game.hnr");
+
+    m_info.stack_amount  = 4;
+    m_info.slice_amount  = 7;
+    m_info.goal          = 3;
+    m_info.result        = 1;
+    m_info.seed          = 0x123456789ABCDEF0ULL;
+    m_info.started_at_ms = 1700000000000LL;
+    m_info.duration_ms   = 123456;
+    m_info.time_limit_ms = 300000;
+
+    // crosses a few checkpoints, and ends between two
+    m_moves = randomGame(m_info, 3 * Replay::CHECKPOINT_INTERVAL + 100, 7);
+
+    QVERIFY(Replay::save(m_path, m_info, m_moves));
+}
+
+void
+TestReplay::roundTrip()
+{
+    Replay replay;
+    QVERIFY(replay.open(m_path));
+
+    const Replay::Info &info = replay.info();
+    QCOMPARE(info.stack_amount, m_info.stack_amount);
+    QCOMPARE(info.slice_amount, m_info.slice_amount);
+    QCOMPARE(info.goal, m_info.goal);
+    QCOMPARE(info.result, m_info.result);
+    QCOMPARE(info.seed, m_info.seed);
+    QCOMPARE(info.started_at_ms, m_info.started_at_ms);
+    QCOMPARE(info.duration_ms, m_info.duration_ms);
+    QCOMPARE(info.time_limit_ms, m_info.time_limit_ms);
+    QCOMPARE(replay.moveCount(), m_moves.size());
+
+    std::vector<Replay::Move> moves;
+    QVERIFY(replay.moves(moves));
+    QVERIFY(moves == m_moves);
+
+    // on, around and between the checkpoints, and both ends of the game
+    const size_t interval = Replay::CHECKPOINT_INTERVAL;
+    const size_t seeks[]  = {
+        0,
+        1,
+        interval - 1,
+        interval,
+        interval + 1,
+        2 * interval + 17,
+        3 * interval,
+        m_moves.size() - 1,
+        m_moves.size(),
+    };
+
+    std::vector<uint8_t> state;
+    for (const size_t n : seeks) {
+        QVERIFY(replay.stateAt(n, state));
+        QVERIFY(state == boardAt(m_info, m_moves, n));
+    }
+
+    QVERIFY(!replay.stateAt(m_moves.size() + 1, state));
+}
+
+void
+TestReplay::emptyGame()
+{
+    QVERIFY(Replay::save(m_path, m_info, {}));
+
+    Replay replay;
+    QVERIFY(replay.open(m_path));
+    QCOMPARE(replay.moveCount(), size_t(0));
+
+    std::vector<Replay::Move> moves;
+    QVERIFY(replay.moves(moves));
+    QVERIFY(moves.empty());
+
+    std::vector<uint8_t> state;
+    QVERIFY(replay.stateAt(0, state));
+    QVERIFY(state == std::vector<uint8_t>(m_info.slice_amount, 0));
+}
+
+void
+TestReplay::truncated()
+{
+    const QByteArray data = readFile(m_path);
+    QVERIFY(data.size() > HEADER_SIZE + FOOTER_SIZE);
+
+    const qint64 lengths[] = {
+        0,
+        4,
+        HEADER_SIZE,
+        HEADER_SIZE + FOOTER_SIZE,
+        data.size() / 2,
+        data.size() - FOOTER_SIZE,
+        data.size() - 1,
+    };
+
+    for (const qint64 length : lengths) {
+        QVERIFY(writeFile(m_path, data.left(length)));
+
+        Replay replay;
+        QVERIFY(!replay.open(m_path));
+    }
+}
+
+void
+TestReplay::corruptCounts()
+{
+    const QByteArray data   = readFile(m_path);
+    const qint64     footer = data.size() - FOOTER_SIZE;
+
+    // past the end of the file, and overflowing once multiplied or cast
+    const uint64_t huge_values[] = {
+        uint64_t(data.size()) * 8 + 1,
+        uint64_t(INT64_MAX),
+        uint64_t(INT64_MAX) + 1,
+        UINT64_MAX,
+        UINT64_MAX / INDEX_ENTRY_SIZE + 1,
+    };
+
+    // the move count, the index offset, and the index count
+    for (const qint64 field : { MOVE_COUNT_AT, footer, footer + 8 }) {
+        for (const uint64_t value : huge_values) {
+            QByteArray corrupt = data;
+            setU64(corrupt, field, value);
+            QVERIFY(writeFile(m_path, corrupt));
+
+            Replay replay;
+            QVERIFY(!replay.open(m_path));
+        }
+    }
+
+    // moves running over the checkpoints
+    QByteArray corrupt = data;
+    setU64(corrupt,
+           MOVE_COUNT_AT,
+           getU64(data, MOVE_COUNT_AT) + Replay::CHECKPOINT_INTERVAL);
+    QVERIFY(writeFile(m_path, corrupt));
+
+    Replay replay;
+    QVERIFY(!replay.open(m_path));
+}
+
+void
+TestReplay::corruptCheckpoint()
+{
+    const QByteArray data         = readFile(m_path);
+    const qint64     index_offset = qint64(getU64(data, data.size() - FOOTER_SIZE));
+
+    // the offset of the second checkpoint, into the header, into the moves,
+    // over the index, and negative once cast
+    const qint64   entry     = index_offset + INDEX_ENTRY_SIZE + 8;
+    const uint64_t offsets[] = {
+        0,
+        uint64_t(HEADER_SIZE),
+        uint64_t(index_offset) - 1,
+        uint64_t(index_offset),
+        uint64_t(-1),
+    };
+
+    std::vector<uint8_t> state;
+
+    for (const uint64_t offset : offsets) {
+        QByteArray corrupt = data;
+        setU64(corrupt, entry, offset);
+        QVERIFY(writeFile(m_path, corrupt));
+
+        Replay replay;
+        QVERIFY(replay.open(m_path));
+
+        // the first checkpoint is still good
+        QVERIFY(replay.stateAt(1, state));
+        QVERIFY(!replay.stateAt(Replay::CHECKPOINT_INTERVAL, state));
+    }
+
+    // a stack label out of range in the second checkpoint
+    QByteArray corrupt = data;
+    corrupt[qint64(getU64(data, entry))] = char(m_info.stack_amount);
+    QVERIFY(writeFile(m_path, corrupt));
+
+    Replay replay;
+    QVERIFY(replay.open(m_path));
+    QVERIFY(!replay.stateAt(Replay::CHECKPOINT_INTERVAL, state));
+}
+
+void
+TestReplay::illegalMove()
+{
+    QByteArray data = readFile(m_path);
+
+    // the first move between stacks 1 and 2, both still empty. it's the
+    // pair at index 3 of 4 stacks
+    const uint8_t bits = Replay::bitsPerMove(m_info.stack_amount);
+    const uint8_t mask = uint8_t((1U << bits) - 1);
+
+    data[HEADER_SIZE] = char((uint8_t(data[HEADER_SIZE]) & ~mask) | 3U);
+    QVERIFY(writeFile(m_path, data));
+
+    Replay replay;
+    QVERIFY(replay.open(m_path));
+
+    std::vector<Replay::Move> moves;
+    QVERIFY(!replay.moves(moves));
+
+    std::vector<uint8_t> state;
+    QVERIFY(!replay.stateAt(1, state));
+}
+
+QTEST_APPLESS_MAIN(TestReplay)
+
+#include "tst_replay.moc"